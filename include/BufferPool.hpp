@@ -0,0 +1,43 @@
+#ifndef BUFFERPOOL_HPP
+# define BUFFERPOOL_HPP
+
+# include <cstddef>
+
+# define BUFFER_CLASS_MIN 512  // smallest size class
+# define BUFFER_CLASS_COUNT 6  // 512 B, 1, 2, 4, 8, 16 KiB
+# define BUFFER_CLASS_MAX (BUFFER_CLASS_MIN << (BUFFER_CLASS_COUNT - 1))
+# define BUFFER_TRIM_MS 1000   // trim() interval of the event loop
+
+struct BufferPoolStats
+{
+	size_t borrowed;       // buffers handed out and not yet returned
+	size_t borrowedBytes;
+	size_t peakBytes;      // highest borrowedBytes seen
+	size_t cached;         // returned buffers kept for reuse
+	size_t cachedBytes;
+	unsigned long hits;    // acquire() served from the cache
+	unsigned long misses;  // acquire() that went to the heap
+	unsigned long trimmed; // cached buffers freed by trim()
+};
+
+// Size-classed pool of byte buffers for connection I/O. A connection borrows a
+// buffer only while it holds unprocessed bytes and gives it back as soon as it
+// drains, so an idle connection costs nothing here. Returned buffers are kept
+// per class, and trim() frees the ones that were not needed during the whole
+// interval since the previous trim(), so a past burst does not pin memory.
+// Core thread only.
+class BufferPool
+{
+	private:
+		BufferPool();
+
+	public:
+		static size_t classSize(size_t bytes);       // smallest class >= bytes, at most BUFFER_CLASS_MAX
+		static char *acquire(size_t capacity);       // capacity must be a classSize()
+		static void release(char *buffer, size_t capacity);
+		static void trim();
+		static void releaseAll();                    // frees every cached buffer
+		static const BufferPoolStats &stats();
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef CASEMAP_HPP
+# define CASEMAP_HPP
+
+# include <string>
+# include <cstddef>
+
+// RFC 1459 casemapping: besides A-Z, "[]\~" are the upper-case forms of "{}|^",
+// so "Nick[1]" and "nick{1}" name the same user. Comparisons go through a
+// precomputed 256-byte fold table.
+extern const unsigned char rfc1459Fold[256];
+
+inline unsigned char ircFold(char c) { return rfc1459Fold[(unsigned char)c]; }
+bool ircEquals(const std::string &a, const std::string &b);
+bool ircLess(const std::string &a, const std::string &b); // folded byte order
+
+// Hash and equality functors for case-mapped keys in hash containers.
+struct IrcHash
+{
+	size_t operator()(const std::string &s) const;
+};
+
+struct IrcEqual
+{
+	bool operator()(const std::string &a, const std::string &b) const { return ircEquals(a, b); }
+};
+
+#endif
@@ -4,16 +4,30 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <tr1/unordered_map>
 #include "Client.hpp"
 
+// kanal içi üye modları; NAMES'te en yüksek olanın öneki gösterilir
+enum MemberFlag
+{
+	MEMBER_OP = 1 << 0,    // '@'
+	MEMBER_VOICE = 1 << 1  // '+'
+};
+
+struct Member
+{
+	Client *client;
+	unsigned flags; // MemberFlag bitleri
+};
+
 class Channel
 {
 	private:
 	    std::string name;
 	    std::string topic;
 	    std::string pin;  
-	    std::vector<Client*> members;
-	    std::vector<Client*> operators;
+	    std::vector<Member> members; // fan-out sırası, boşluksuz; çıkışta swap-remove
+	    std::tr1::unordered_map<Client*, size_t> memberIndex; // Client -> members'taki yer
 	    std::vector<std::string> invitedNicks;
 	    bool invite_only;
 	    bool topic_restricted;
@@ -27,20 +41,24 @@ class Channel
 	    void removeClient(Client* client);
 	    bool hasClient(Client* client);
 	
-	    std::string getName() const;
+	    const std::string& getName() const;
 	    std::string getTopic() const;
 	    void setTopic(const std::string& newTopic);
 	    bool hasKey() const;
 	    bool checkKey(const std::string& providedKey) const;
 	    void setKey(const std::string& newKey);
 	
-	    std::vector<Client*> getMembers() const;
+	    const std::vector<Member>& getMembers() const;
+	    unsigned getFlags(Client* client) const;
+	    void setFlag(Client* client, unsigned flag, bool on);
+	    std::string namesList() const;
 	    bool isOperator(Client* client);
 	    void addOperator(Client* client);
 	    void removeOperator(Client* client);
 	    size_t getMemberCount() const;
 	
 	    void sendMsg(const std::string& message, Client* sender = NULL);
+	    void sendMsg(SharedMessage* message, Client* sender = NULL); // caller keeps its reference
 	
 	    bool isInviteOnly() const;
 	    void setInviteOnly(bool value);
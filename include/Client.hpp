@@ -2,29 +2,68 @@
 # define CLIENT_HPP
 
 # include <string>
+# include <vector>
+# include <set>
+# include <ctime>
 # include <netinet/in.h>
+# include "OutQueue.hpp"
+# include "SendQ.hpp"
+# include "InputBuffer.hpp"
+# include "TimerWheel.hpp"
+
+class Channel;
+
+// Rarely read per-client data: registration details, AWAY text, the peer
+// address and the joined channels. Kept out of line so the Client record that
+// channel fan-out and flushPending() walk stays small.
+struct ClientProfile
+{
+	std::string username;
+	std::string realname;
+	std::string hostname;
+	std::string awayMessage;
+	std::set<Channel *> channels; // üye olunan kanallar, Channel::addClient/removeClient günceller
+	struct sockaddr_in in_soc;
+	Timer keepalive;              // kayıt süresi, sonra PING/ping timeout (Server::keepalive)
+	unsigned long long pingSent;  // cevap beklenen PING'in zamanı (ms), yoksa 0
+	time_t signon;                // bağlantı zamanı (wall clock), WHOIS 317
+};
 
 class Client
 {
 	private:
+		// her yayın alıcısında ve flush'ta okunanlar, outbuf ile aynı cache satırlarında
 	    int fd;
-	    std::string nick;
-	    std::string username;
-		std::string realname;
-		std::string hostname;
-	    bool is_authenticated;
+		int sendq_excess;               // SendQClass::Reason, NONE değilse çıkış sırada
 	    bool is_registered;
+		bool is_pending;          // fd'si pendingList'te, flush bekliyor
+		bool write_armed;         // reactor'da WRITE ilgisi açık
+	    bool is_authenticated;
 	    bool away;
-	    std::string awayMessage;
+		bool oper;                // OPER ile sunucu operatörü oldu
+		std::vector<int> *pendingList;
+		const SendQClass *sendqClasses; // Server'ın sınıf tablosu, indeks SendQClass::Id
+
+	public:
+		OutQueue outbuf;//output bufferı, yayınlar paylaşılan bloklar olarak tutulur
+		InputBuffer inbuf; //input buffer for partial commands
+
+	private:
+	    std::string nick;
+		mutable std::string prefix; // ":nick!user@host", boşsa getPrefix() yeniden kurar
+		unsigned long long lastInput; // son okunan veri (monotonic ms), her okumada yazılır
+		unsigned long long lastActivity; // son PRIVMSG/NOTICE (monotonic ms), idle süresi buradan
+		ClientProfile *profile;     // soğuk alanlar, Client ile birlikte açılıp silinir
+
+		Client(const Client &);
+		Client &operator=(const Client &);
+
+		void checkSendQ();
 		
 		public:
 		Client();
 	    Client(int _fd);
 	    ~Client();
-		
-		struct sockaddr_in in_soc;
-		std::string outbuf;//output bufferı
-		std::string inbuf; //input buffer for partial commands
 
 	    int getFd();
 		void setFd(int _fd);
@@ -32,18 +71,51 @@ class Client
 		void setAuth(bool i);
 		bool getRegis();
 		void setRegis(bool i);
-		std::string getNick();
-		std::string getRname();
-		std::string getUname();
-		std::string getHname();
+		const std::string &getNick() const;
+		const std::string &getRname() const;
+		const std::string &getUname() const;
+		const std::string &getHname() const;
+		const std::string &getPrefix() const;
+		struct sockaddr_in &getAddr();
+		Timer &getTimer();
+		unsigned long long getLastInput() const;
+		void setLastInput(unsigned long long ms);
+		unsigned long long getPingSent() const;
+		void setPingSent(unsigned long long ms);
+		unsigned long long getLastActivity() const;
+		void setLastActivity(unsigned long long ms);
+		time_t getSignon() const;
+		void setSignon(time_t when);
 		void setNick(std::string nick);
 		void setUname(std::string username);
 		void setRname(std::string realname);
 		void setHname(std::string hostname);
 		bool isAway();
 		void setAway(bool status);
-		std::string getAwayMessage();
+		bool isOper() const;
+		void setOper(bool status);
+		const std::string &getAwayMessage() const;
 		void setAwayMessage(std::string message);
+		const std::set<Channel *> &getChannels() const;
+		bool inChannel(Channel *channel) const;
+		void joinChannel(Channel *channel);
+		void partChannel(Channel *channel);
+
+		void setPendingList(std::vector<int> *list);
+		void setSendQClasses(const SendQClass *classes);
+		int getSendQClass();
+		int getSendQExcess();
+		void resetSendQ();
+		void queue(const std::string &line);
+		void queue(SharedMessage *msg);
+		void queueTail(size_t bytes); // bytes were written into outbuf.joinableTail() (Reply)
+		size_t bufferedBytes() const; // unprocessed input + unsent output
+		static unsigned long long queuedBytes(); // bytes ever queued to any client (core thread)
+		static unsigned long long queuedMessages(); // the same in IRC lines
+		void markPending();
+		void clearPending();
+		bool isWriteArmed();
+		void setWriteArmed(bool armed);
 
 };
 
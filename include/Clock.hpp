@@ -0,0 +1,47 @@
+#ifndef CLOCK_HPP
+# define CLOCK_HPP
+
+# include <ctime>
+# include <string>
+
+// Time as seen by the event loop. update() reads the monotonic and the wall
+// clock once per loop iteration; everything handled in that iteration (reads,
+// commands, timers) uses the cached values, so the message path never asks the
+// kernel for the time. Timeouts and idle times use the monotonic clock, which
+// does not jump when the wall clock is set; the wall clock is only for what is
+// shown to users.
+class Clock
+{
+	private:
+		unsigned long long monotonic; // ms, CLOCK_MONOTONIC
+		unsigned long long wall;      // ms since the epoch, CLOCK_REALTIME
+		unsigned long long cycleBase; // cycles() and monotonic ns at construction,
+		unsigned long long nsBase;    // for cycleNs()
+
+	public:
+		Clock();
+
+		void update();
+		unsigned long long monotonicMs() const;
+		unsigned long long wallMs() const;
+		time_t wallSeconds() const;
+
+		// Cheapest available timestamp for timing short code paths: the TSC on
+		// x86 (constant rate on current CPUs), monotonic ns elsewhere. Not
+		// cached; cycleNs() converts a difference of two readings to ns.
+		static unsigned long long cycles()
+		{
+# if defined(__x86_64__) || defined(__i386__)
+			return __builtin_ia32_rdtsc();
+# else
+			struct timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+# endif
+		}
+		double cycleNs() const; // ns per cycles() unit, measured since construction
+
+		static std::string format(time_t when); // "Sat Oct 18 2026 at 09:15:02 UTC"
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef COMMANDS_HPP
+# define COMMANDS_HPP
+
+# include <string>
+# include <vector>
+# include <cstddef>
+
+class Server;
+class Client;
+
+typedef void (Server::*CommandHandler)(const std::vector<std::string> &params, Client &client);
+
+// One row of the static command registry. commandHandler() applies the
+// registration and parameter checks before calling the handler, so handlers
+// may assume both.
+struct CommandEntry
+{
+	const char *name;       // canonical upper-case name, used in replies
+	CommandHandler handler;
+	bool needsRegistration; // 451 before registration
+	size_t minParams;       // 461 below this; 0 when the handler has its own numeric
+	unsigned cost;          // flood weight of one use
+};
+
+// Case-insensitive lookup by (length, first letter); NULL for unknown commands.
+const CommandEntry *findCommand(const char *name, size_t len);
+
+// The registry as a dense array, for per-command statistics.
+size_t commandCount();
+const CommandEntry &commandAt(size_t index);
+size_t commandIndex(const CommandEntry *entry);
+
+#endif
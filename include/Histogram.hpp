@@ -0,0 +1,53 @@
+#ifndef HISTOGRAM_HPP
+# define HISTOGRAM_HPP
+
+# include <cstddef>
+
+# define HISTOGRAM_SUB_BITS 4  // 16 buckets per power of two: at most 6.25% error
+# define HISTOGRAM_MAX_BITS 40 // larger values land in the last bucket
+# define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+# define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+
+// Log-linear (HDR style) histogram of unsigned values: exact below 16, then
+// every power of two is split into 16 equal buckets, so the relative error
+// is bounded while the bucket count stays fixed. record() is a few
+// instructions and one counter increment; percentiles are computed on read.
+class Histogram
+{
+	private:
+		unsigned long long total; // önde: sahibinin sayaçlarıyla aynı cache satırında
+		unsigned long long maxValue;
+		unsigned long long sumValue;
+		unsigned long long counts[HISTOGRAM_BUCKETS];
+
+		static size_t index(unsigned long long value)
+		{
+			if (value < HISTOGRAM_SUB_COUNT)
+				return value;
+			int msb = 63 - __builtin_clzll(value);
+			if (msb >= HISTOGRAM_MAX_BITS)
+				return HISTOGRAM_BUCKETS - 1;
+			int shift = msb - HISTOGRAM_SUB_BITS;
+			return ((shift + 1) << HISTOGRAM_SUB_BITS) + ((value >> shift) & (HISTOGRAM_SUB_COUNT - 1));
+		}
+		static unsigned long long upperBound(size_t index);
+
+	public:
+		Histogram();
+
+		void record(unsigned long long value)
+		{
+			++this->counts[index(value)];
+			++this->total;
+			this->sumValue += value;
+			if (value > this->maxValue)
+				this->maxValue = value;
+		}
+		unsigned long long count() const;
+		unsigned long long max() const;
+		unsigned long long sum() const;
+		unsigned long long percentile(double fraction) const; // e.g. 0.99; upper edge of its bucket
+		void reset();
+};
+
+#endif
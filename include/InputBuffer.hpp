@@ -0,0 +1,57 @@
+#ifndef INPUTBUFFER_HPP
+# define INPUTBUFFER_HPP
+
+# include <string>
+# include <cstddef>
+# include <sys/types.h>
+# include "BufferPool.hpp"
+
+// RFC 1459: 512 bytes with CRLF; IRCv3 message tags may add up to 8191 more.
+# define IRC_LINE_MAX 512
+# define IRC_TAGS_MAX 8191
+# define INPUT_RING_SIZE BUFFER_CLASS_MAX // largest ring, > IRC_LINE_MAX + IRC_TAGS_MAX
+# define INPUT_RING_MIN 1024                // first ring a connection borrows
+
+// Ring of received bytes borrowed from the BufferPool. Lines are framed where
+// they lie; only a line that wraps past the end of the ring is copied out. The
+// ring starts small and moves to the next size class when it fills up, up to
+// INPUT_RING_SIZE. A line that grows past its limit without a newline is
+// discarded up to the next newline, so a client can never hold more than
+// INPUT_RING_SIZE bytes here. The ring goes back to the pool whenever it
+// drains, so idle clients hold none.
+class InputBuffer
+{
+	private:
+		char *ring;
+		size_t capacity; // 0 while no ring is borrowed
+		size_t want;     // size class to borrow next, follows how full reads get
+		size_t head;     // first unconsumed byte
+		size_t count;    // unconsumed bytes
+		size_t scanned;  // bytes after head known to hold no '\n'
+		bool discarding; // dropping the rest of an over-long line
+		std::string wrapped;
+
+		InputBuffer(const InputBuffer &);
+		InputBuffer &operator=(const InputBuffer &);
+
+		void reserve(size_t bytes);
+		void release();
+		void drop(size_t n);
+		size_t findNewline();
+
+	public:
+		enum Status { NONE, LINE, TOO_LONG };
+
+		InputBuffer();
+		~InputBuffer();
+
+		ssize_t readFrom(int fd);                     // one readv() into the free space
+		size_t append(const char *data, size_t len);  // returns the bytes taken
+		int nextLine(const char *&line, size_t &len); // CR/LF stripped, valid until the next call
+		size_t size() const;
+		size_t space() const;    // free bytes without growing
+		size_t reserved() const; // bytes borrowed from the pool
+		void clear();
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef IRCMESSAGE_HPP
+# define IRCMESSAGE_HPP
+
+# include <string>
+# include <cstddef>
+
+// (pointer, length) view into a framed input line; never owns memory.
+struct IrcSpan
+{
+	const char *data;
+	size_t len;
+
+	bool empty() const { return len == 0; }
+	bool equals(const char *s) const;
+	std::string str() const { return std::string(data, len); }
+};
+
+// One parsed line: [@tags] [:prefix] command params... [:trailing]
+// RFC 1459 allows 15 parameters; once 14 middle params are taken the rest of
+// the line becomes the last one, as if it had a ':'. All spans point into the
+// caller's buffer and are valid only as long as it is.
+struct IrcMessage
+{
+	enum { MAX_PARAMS = 15 };
+
+	IrcSpan tags;    // without the leading '@'
+	IrcSpan prefix;  // without the leading ':'
+	IrcSpan command;
+	IrcSpan params[MAX_PARAMS]; // middle params, trailing not included
+	size_t paramCount;
+	IrcSpan trailing;
+	bool hasTrailing;
+};
+
+// Fills msg from line (CR/LF already stripped). No heap allocation.
+// Returns false if the line has no command.
+bool parseMessage(const char *line, size_t len, IrcMessage &msg);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef LOG_HPP
+# define LOG_HPP
+
+# include <string>
+# include <cstddef>
+# include "IrcMessage.hpp"
+
+# define LOG_LINE_MAX 512    // bytes of text per record, longer lines are cut
+# define LOG_RING_SLOTS 2048 // records in flight, power of two
+# define LOG_FLUSH_MS 10     // writer's poll interval while there is traffic
+# define LOG_IDLE_MS 1000    // quiet this long, the writer sleeps until woken
+
+// Usage: LOG(CMD, DEBUG) << "line " << fd;  a filtered-out line costs one
+// compare, its arguments are not evaluated.
+# define LOG(subsystem, level) \
+	if (!Log::enabled(Log::subsystem, Log::level)) {} \
+	else LogLine(Log::subsystem, Log::level)
+
+struct LogStats
+{
+	unsigned long logged;    // records put into the ring
+	unsigned long dropped;   // records lost because the ring was full
+	unsigned long truncated; // records cut at LOG_LINE_MAX
+	unsigned long written;   // records written out
+};
+
+// Process-wide logger. Producers format into a stack buffer and copy it into
+// a bounded lock-free ring (one sequence number per slot, any number of
+// producer threads), never blocking and never calling into the kernel; when
+// the ring is full the record is dropped and counted. A writer thread started
+// by start() turns records into text and writes them out in batches, DEBUG and
+// INFO to stdout, WARN and ERROR to stderr. Before start() and after stop()
+// records are written synchronously.
+class Log
+{
+	public:
+		enum Level { DEBUG, INFO, WARN, ERROR, OFF };
+		enum Subsystem { CORE, NET, CMD, SUBSYSTEM_COUNT };
+
+	private:
+		static unsigned char thresholds[SUBSYSTEM_COUNT];
+
+	public:
+		static bool enabled(Subsystem subsystem, Level level)
+		{
+			return level >= thresholds[subsystem];
+		}
+		static void configure(const std::string &spec); // "debug" or "cmd=debug,net=warn"
+		static void setTime(unsigned long long wallMs);   // stamp for the records that follow
+		static void write(Subsystem subsystem, Level level, const char *text, size_t len, bool truncated);
+		static void start();
+		static void stop(); // writes out what is queued
+		static LogStats stats();
+};
+
+// One log record built in place; handed to Log::write() by the destructor.
+class LogLine
+{
+	private:
+		Log::Subsystem subsystem;
+		Log::Level level;
+		size_t length;
+		bool truncated;
+		char text[LOG_LINE_MAX];
+
+		LogLine(const LogLine &);
+		LogLine &operator=(const LogLine &);
+
+	public:
+		LogLine(Log::Subsystem subsystem, Log::Level level);
+		~LogLine();
+
+		LogLine &append(const char *data, size_t len);
+		LogLine &operator<<(const std::string &s);
+		LogLine &operator<<(const char *s);
+		LogLine &operator<<(const IrcSpan &s);
+		LogLine &operator<<(char c);
+		LogLine &operator<<(int n);
+		LogLine &operator<<(unsigned long n);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef METRICS_HPP
+# define METRICS_HPP
+
+# include <string>
+# include "OutQueue.hpp"
+# include "TimerWheel.hpp"
+
+# define METRICS_REQUEST_MAX 4096 // request bytes a scrape may send before its answer
+# define METRICS_MAX_SCRAPES 16   // scrape connections open at once, more are refused
+# define METRICS_TIMEOUT_MS 5000  // a scrape not finished by then is closed
+
+// Why a client connection ended, counted for irc_disconnects_total.
+enum DisconnectReason
+{
+	DISCONNECT_CLOSED,       // peer closed the socket, after QUIT or not
+	DISCONNECT_ERROR,        // read or send failed
+	DISCONNECT_PING,         // ping timeout
+	DISCONNECT_REGISTRATION, // registration timeout
+	DISCONNECT_IDLE,         // idle timeout
+	DISCONNECT_SENDQ,        // excess SendQ
+	DISCONNECT_REASONS
+};
+
+struct ConnectionStats
+{
+	unsigned long long accepted;
+	unsigned long long disconnects[DISCONNECT_REASONS];
+	unsigned long long scrapes; // metrics responses sent
+
+	ConnectionStats();
+
+	static const char *reasonName(int reason);
+};
+
+// One connection to the metrics socket: the request is collected until it is
+// complete, then the whole response is queued and sent, then it is closed.
+struct MetricsScrape
+{
+	int fd;
+	bool answered;
+	std::string request;
+	OutQueue response;
+	Timer deadline; // METRICS_TIMEOUT_MS after accept
+
+	explicit MetricsScrape(int fd);
+
+	bool complete() const; // a blank line ends an HTTP request, a newline anything else
+	bool isHttp() const;   // request line ends with HTTP/x.y
+};
+
+// Writes the Prometheus text exposition format (version 0.0.4) into a string:
+// a family() header, then its samples. Label sets are preformatted with
+// label(); values are escaped there.
+class MetricsText
+{
+	private:
+		std::string &out;
+
+		MetricsText(const MetricsText &);
+		MetricsText &operator=(const MetricsText &);
+
+		void name(const char *metric, const std::string &labels);
+
+	public:
+		explicit MetricsText(std::string &out);
+
+		void family(const char *metric, const char *type, const char *help);
+		void sample(const char *metric, const std::string &labels, unsigned long long value);
+		void sample(const char *metric, const std::string &labels, double value);
+
+		static std::string label(const char *key, const std::string &value);
+		static std::string label(const char *key, const std::string &value, const char *key2, const std::string &value2);
+};
+
+#endif
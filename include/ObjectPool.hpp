@@ -0,0 +1,149 @@
+#ifndef OBJECTPOOL_HPP
+# define OBJECTPOOL_HPP
+
+# include <vector>
+# include <new>
+# include <cstddef>
+# include <cstdlib>
+
+# define CACHE_LINE 64
+
+// Occupancy counters of one pool.
+struct PoolStats
+{
+	size_t slabs;
+	size_t capacity;      // slots in all slabs
+	size_t inUse;
+	size_t peak;          // highest inUse seen
+	unsigned long reused; // create() served from the free list
+	unsigned long fresh;  // create() that took a never-used slot
+};
+
+// Slab-backed pool of T. Slots are carved from fixed-size slabs that are never
+// moved or returned, so a pointer stays valid for the object's whole life and
+// a freed slot is reused LIFO (still warm in cache) by the next create().
+// Every slot starts on a cache line, so the leading fields of T (its hot part)
+// always share the fewest lines.
+// Not thread safe; Client and Channel only live on the core thread.
+template <typename T, size_t SlabSize = 64>
+class ObjectPool
+{
+	private:
+		struct Slot
+		{
+			union // nesne slotun başında, hizalı durur
+			{
+				char storage[sizeof(T)];
+				double alignDouble;
+				void *alignPointer;
+			};
+			Slot *nextFree;
+		};
+
+		// slot adımı cache satırına yuvarlanır; slab'lar satır hizalı alınır
+		static const size_t Stride = (sizeof(Slot) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+
+		std::vector<char *> slabs;
+		Slot *freeList;
+		PoolStats counters;
+
+		ObjectPool(const ObjectPool &);
+		ObjectPool &operator=(const ObjectPool &);
+
+		Slot *acquire()
+		{
+			Slot *slot = this->freeList;
+			if (slot)
+			{
+				this->freeList = slot->nextFree;
+				++this->counters.reused;
+			}
+			else
+			{
+				if (this->counters.inUse == this->counters.capacity)
+					grow();
+				slot = this->freeList;
+				this->freeList = slot->nextFree;
+				++this->counters.fresh;
+			}
+			if (++this->counters.inUse > this->counters.peak)
+				this->counters.peak = this->counters.inUse;
+			return slot;
+		}
+
+		Slot *slotAt(char *slab, size_t i) const
+		{
+			return reinterpret_cast<Slot *>(slab + i * Stride);
+		}
+
+		// yeni slab'ın slotları boş listeye sırayla eklenir
+		void grow()
+		{
+			void *memory;
+			if (posix_memalign(&memory, CACHE_LINE, Stride * SlabSize) != 0)
+				throw std::bad_alloc();
+			char *slab = static_cast<char *>(memory);
+			for (size_t i = SlabSize; i-- > 0; )
+			{
+				Slot *slot = slotAt(slab, i);
+				slot->nextFree = this->freeList;
+				this->freeList = slot;
+			}
+			this->slabs.push_back(slab);
+			++this->counters.slabs;
+			this->counters.capacity += SlabSize;
+		}
+
+		static Slot *slotOf(T *object)
+		{
+			return reinterpret_cast<Slot *>(object);
+		}
+
+		void release(Slot *slot)
+		{
+			slot->nextFree = this->freeList;
+			this->freeList = slot;
+			--this->counters.inUse;
+		}
+
+	public:
+		ObjectPool() : freeList(NULL)
+		{
+			PoolStats zero = { 0, 0, 0, 0, 0, 0 };
+			this->counters = zero;
+		}
+
+		// canlı nesneler sahiplerince destroy() edilmiş olmalı; kalanların yıkıcısı çağrılmaz
+		~ObjectPool()
+		{
+			for (size_t i = 0; i < this->slabs.size(); ++i)
+				free(this->slabs[i]);
+		}
+
+		T *create()
+		{
+			Slot *slot = acquire();
+			try { return new (slot->storage) T(); }
+			catch (...) { release(slot); throw; }
+		}
+
+		template <typename A>
+		T *create(const A &arg)
+		{
+			Slot *slot = acquire();
+			try { return new (slot->storage) T(arg); }
+			catch (...) { release(slot); throw; }
+		}
+
+		void destroy(T *object)
+		{
+			if (!object)
+				return;
+			object->~T();
+			release(slotOf(object));
+		}
+
+		const PoolStats &stats() const { return this->counters; }
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef OUTQUEUE_HPP
+# define OUTQUEUE_HPP
+
+# include <string>
+# include <vector>
+# include <cstddef>
+# include <sys/types.h>
+
+// Immutable, reference counted block of wire bytes. A channel broadcast builds
+// one and every recipient's OutQueue holds a pointer to it, so the line is
+// copied once instead of once per member. The reference count is not atomic:
+// a block never leaves the thread that created it. Released blocks are kept on
+// a small per-thread spare list with their capacity, so steady traffic does
+// not go back to the heap for every line.
+class SharedMessage
+{
+	private:
+		std::string bytes;
+		size_t refs;
+		size_t lines; // IRC messages in bytes
+		SharedMessage *nextSpare;
+
+		SharedMessage();
+		SharedMessage(const SharedMessage &);
+		SharedMessage &operator=(const SharedMessage &);
+		~SharedMessage();
+
+	public:
+		static SharedMessage *create();                        // empty, refs = 1
+		static SharedMessage *create(const std::string &line); // refs = 1
+
+		void retain();
+		void release();
+		bool unique() const;
+		void append(const std::string &line); // only valid while unique()
+		void swap(std::string &other, size_t lineCount); // only valid while unique()
+		std::string &text();                  // in-place writing, only valid while unique()
+		void addLine();                       // one more line was written into text()
+		const char *data() const;
+		size_t size() const;
+		size_t lineCount() const;
+
+		static size_t liveCount();     // blocks currently allocated, spares included
+		static void releaseSpares();   // frees this thread's spare list
+};
+
+// Per-connection output queue: a list of shared blocks plus the offset already
+// sent from the first one. Bytes are only read again when they are sent, and a
+// partial write just moves the offset, nothing is shifted.
+class OutQueue
+{
+	private:
+		std::vector<SharedMessage *> blocks; // [headBlock, size) are queued
+		size_t headBlock;
+		size_t headOffset;
+		size_t total;    // unsent bytes
+		size_t messages; // lines in the queued blocks, a half-sent one included
+
+		OutQueue(const OutQueue &);
+		OutQueue &operator=(const OutQueue &);
+
+	public:
+		OutQueue();
+		~OutQueue();
+
+		void push(SharedMessage *msg);      // takes a new reference
+		void push(const std::string &line); // private reply, may join the tail block
+		SharedMessage *joinableTail();      // tail block a private reply may be written into, or NULL
+		void grewTail(size_t bytes);        // one line of bytes was written into joinableTail()
+		void adopt(std::string &bytes, size_t lines); // takes bytes as a new block (swap, no copy)
+		bool empty() const;
+		size_t size() const;
+		size_t messageCount() const;
+		size_t blockCount() const;
+
+		const char *front(size_t &len) const; // unsent part of the first block
+		void consume(size_t n);
+		ssize_t writeTo(int fd, size_t &offered); // one sendmsg() over up to IOV_MAX blocks
+		void moveTo(std::string &out);        // flatten and clear (worker/uring hand-off)
+		void clear();
+};
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef REACTOR_HPP
+# define REACTOR_HPP
+
+# include <string>
+# include <vector>
+# include <poll.h>
+# include "OutQueue.hpp"
+
+struct ReactorEvent
+{
+	int fd;
+	unsigned int events;
+	int result;       // ACCEPTED: accepted fd, DATA: byte count
+	const char *data; // DATA: bytes already received (valid until the next wait)
+};
+
+// Common interface for the server's event loop: register fds, wait for readiness.
+class Reactor
+{
+	public:
+		enum
+		{
+			READ = 1,
+			WRITE = 2,
+			ERROR = 4,
+			// completion-based backends only
+			ACCEPTED = 8, // listener produced a new connection (result)
+			DATA = 16,    // bytes were received into data/result
+			HANGUP = 32   // connection is finished, owner should close it
+		};
+
+		virtual ~Reactor();
+
+		virtual const char *name() const = 0;
+		virtual void add(int fd, unsigned int events) = 0;
+		virtual void modify(int fd, unsigned int events) = 0;
+		virtual void remove(int fd) = 0;
+		virtual void addListener(int fd);
+		// completion-based backends accept, receive and send by themselves
+		virtual bool completionBased() const;
+		// drains queue if no send is in flight for fd; WRITE is reported when done
+		virtual bool submitSend(int fd, OutQueue &queue);
+		// Fills ready with the fds that are ready, returns the count (-1 on error, errno set)
+		virtual int wait(std::vector<ReactorEvent> &ready, int timeoutMs) = 0;
+
+		// "uring", "epoll", "poll" or "auto" (epoll on linux, poll elsewhere)
+		static Reactor *create(const std::string &backend);
+};
+
+class PollReactor : public Reactor
+{
+	private:
+		std::vector<struct pollfd> pfds;
+		std::vector<int> slots; // fd -> index in pfds, -1 if not registered
+
+		int find(int fd) const;
+
+	public:
+		PollReactor();
+		~PollReactor();
+
+		const char *name() const;
+		void add(int fd, unsigned int events);
+		void modify(int fd, unsigned int events);
+		void remove(int fd);
+		int wait(std::vector<ReactorEvent> &ready, int timeoutMs);
+};
+
+# if defined(__linux__)
+#  include <sys/epoll.h>
+
+class EpollReactor : public Reactor
+{
+	private:
+		int epfd;
+		size_t registered;
+		std::vector<struct epoll_event> events;
+
+		EpollReactor(const EpollReactor &);
+		EpollReactor &operator=(const EpollReactor &);
+
+	public:
+		EpollReactor();
+		~EpollReactor();
+
+		const char *name() const;
+		void add(int fd, unsigned int events);
+		void modify(int fd, unsigned int events);
+		void remove(int fd);
+		int wait(std::vector<ReactorEvent> &ready, int timeoutMs);
+};
+#  include <stdint.h>
+#  include <linux/io_uring.h>
+#  ifdef IORING_RECV_MULTISHOT
+#   define HAVE_IO_URING 1
+#  endif
+# endif
+
+# ifdef HAVE_IO_URING
+
+// io_uring backend: multishot accept, multishot recv from a registered buffer
+// ring, sends batched into the same io_uring_enter() that waits.
+class UringReactor : public Reactor
+{
+	private:
+		struct Slot
+		{
+			uint32_t gen;
+			bool listener;
+			bool rearm;
+			bool sending;
+			std::string inflight;
+			size_t offset;
+		};
+
+		int ringFd;
+		unsigned int features;
+		void *sqRing;
+		void *cqRing;
+		size_t sqRingSize;
+		size_t cqRingSize;
+		struct io_uring_sqe *sqes;
+		size_t sqesSize;
+		unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+		unsigned *cqHead, *cqTail, *cqMask;
+		struct io_uring_cqe *cqes;
+		unsigned sqLocalTail;
+		unsigned sqEntries;
+
+		struct io_uring_buf_ring *bufRing;
+		char *bufBase;
+		unsigned bufCount;
+		unsigned bufSize;
+		std::vector<unsigned short> recycle;
+
+		std::vector<Slot> slots; // fd -> Slot
+		std::vector<int> rearmFds;
+		std::vector<std::pair<uint64_t, std::string> > orphans; // sends still owned by the kernel
+
+		UringReactor(const UringReactor &);
+		UringReactor &operator=(const UringReactor &);
+
+		void setup();
+		void teardown();
+		Slot &slot(int fd);
+		struct io_uring_sqe *getSqe();
+		int enter(unsigned minComplete, int timeoutMs);
+		void armAccept(int fd);
+		void armRecv(int fd);
+		void armSend(int fd);
+		void recycleBuffers();
+		void releaseOrphan(uint64_t userData);
+
+	public:
+		UringReactor();
+		~UringReactor();
+
+		const char *name() const;
+		void add(int fd, unsigned int events);
+		void addListener(int fd);
+		void modify(int fd, unsigned int events);
+		void remove(int fd);
+		bool completionBased() const;
+		bool submitSend(int fd, OutQueue &queue);
+		int wait(std::vector<ReactorEvent> &ready, int timeoutMs);
+};
+# endif
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef REPLY_HPP
+# define REPLY_HPP
+
+# include <string>
+# include "Client.hpp"
+
+// Builds one IRC line in place: straight into the recipient's output queue
+// (joining its tail block when possible), or into a new shared block for a
+// channel broadcast. Each piece is copied once, into the bytes that will be
+// sent, so no temporary strings are made. Only one Reply per client may be
+// open at a time; a Reply that is neither sent nor taken leaves no trace.
+class Reply
+{
+	private:
+		Client *client;       // NULL for a broadcast
+		SharedMessage *block;
+		std::string *out;     // block->text()
+		size_t start;         // where this line begins in out
+		bool joined;          // writing into the client's queued tail block
+
+		Reply(const Reply &);
+		Reply &operator=(const Reply &);
+
+		void finish();
+
+	public:
+		explicit Reply(Client &to); // private reply or relay to one client
+		Reply();                    // broadcast line, see take()
+		~Reply();
+
+		Reply &operator<<(const std::string &s);
+		Reply &operator<<(const char *s);
+		Reply &operator<<(char c);
+		Reply &numeric(const char *code, const Client &to); // ":server <code> <nick|*>"
+
+		void send();           // CRLF, queue accounting and SendQ check
+		SharedMessage *take(); // CRLF; the caller owns the returned reference
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SENDQ_HPP
+# define SENDQ_HPP
+
+# include <cstddef>
+
+// Send-queue limits of one connection class. A client whose unsent output goes
+// over either limit is disconnected with "Excess SendQ"; its stream is never cut.
+struct SendQClass
+{
+	enum Id { UNREGISTERED, USER, COUNT };
+	enum Reason { NONE, BYTES, MESSAGES };
+
+	const char *name;
+	size_t maxBytes;
+	size_t maxMessages;
+	unsigned long excessBytes;    // disconnects caused by maxBytes
+	unsigned long excessMessages; // disconnects caused by maxMessages
+};
+
+#endif
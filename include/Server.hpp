@@ -21,42 +21,208 @@
 # include <cstdio>
 # include <cerrno>
 # include <exception>
+# include <stdexcept>
 # include <algorithm>
 # include <cctype>
+# include <ctime>
+# include <tr1/unordered_map>
 # include "Client.hpp"
 # include "Channel.hpp"
+# include "Reactor.hpp"
+# include "Worker.hpp"
+# include "SendQ.hpp"
+# include "IrcMessage.hpp"
+# include "Commands.hpp"
+# include "CaseMap.hpp"
+# include "Reply.hpp"
+# include "ObjectPool.hpp"
+# include "TimerWheel.hpp"
+# include "Clock.hpp"
+# include "Log.hpp"
+# include "Histogram.hpp"
+# include "Metrics.hpp"
 
-# define BACKLOG 10
+# define BACKLOG 128
 # define BUF_SIZE 1024
+# define READ_BUDGET 65536 // bir client'tan tur başına okunacak en fazla byte
+# define PING_INTERVAL 120       // saniye; bu kadar sessiz kalan client'a PING gider
+# define PING_TIMEOUT 60         // saniye; PING'e bu sürede hiçbir şey gelmezse bağlantı kapanır
+# define REGISTRATION_TIMEOUT 60 // saniye; kaydı bitmeyen bağlantı kapanır
+# define SLOW_THRESHOLD_MS 10    // bundan uzun süren komut ve döngü turu loglanır
+# define LAG_LEVELS 3            // 1, 10, 100 ms'yi aşan turlar ayrı sayılır
+
+# ifndef MSG_NOSIGNAL
+#  define MSG_NOSIGNAL 0
+# endif
 
 //class Channel;
 
+// RFC 1459 casemapping ile nick -> Client
+typedef std::tr1::unordered_map<std::string, Client *, IrcHash, IrcEqual> NickMap;
+// aynı casemapping ile kanal adı -> Channel; anahtar kurucunun yazdığı haliyle kalır
+typedef std::tr1::unordered_map<std::string, Channel *, IrcHash, IrcEqual> ChannelMap;
+
+// LIST/NAMES ve WHOIS'in kanal sırası: casemapping'e göre ada göre
+struct ChannelNameLess
+{
+	bool operator()(const Channel *a, const Channel *b) const { return ircLess(a->getName(), b->getName()); }
+};
+
+// Timer::kind, runTimers() buna göre dağıtır
+enum TimerKind
+{
+	TIMER_CLIENT, // data = Client*, Server::keepalive
+	TIMER_TRIM,   // BufferPool::trim
+	TIMER_SCRAPE  // data = MetricsScrape*, süresi dolan scrape kapanır
+};
+
+// commandHandler()'ın komut başına ölçümleri (STATS m); çağrı sayısı latency.count()
+struct CommandStats
+{
+	unsigned long long bytesIn;  // komut satırlarının byte'ları
+	unsigned long long bytesOut; // handler çalışırken herhangi bir client'a kuyruklanan byte'lar
+	unsigned long long messagesOut; // aynısı IRC satırı olarak
+	Histogram latency;           // handler süresi, Clock::cycles() biriminde
+
+	CommandStats() : bytesIn(0), bytesOut(0), messagesOut(0) {}
+};
+
+// Event loop turlarının ölçümü (STATS e); süreler Clock::cycles() biriminde
+struct LoopStats
+{
+	Histogram busy;                       // tur başına iş: olaylar, timer'lar, flush
+	unsigned long long worked;            // busy'nin toplamı
+	unsigned long long waited;            // reactor->wait() içinde geçen toplam
+	unsigned long long over[LAG_LEVELS];  // 1, 10, 100 ms'yi aşan turlar
+	unsigned long long limits[LAG_LEVELS]; // aynı eşikler cycles olarak, start()'ta ölçülür
+	unsigned long long slowLimit;         // slowMs cycles olarak, ölçülene kadar hiç aşılmaz
+	unsigned long slowTurns;
+	unsigned long slowCommands;
+
+	LoopStats() : worked(0), waited(0), slowLimit(~0ULL), slowTurns(0), slowCommands(0)
+	{
+		for (int i = 0; i < LAG_LEVELS; ++i)
+		{
+			over[i] = 0;
+			limits[i] = ~0ULL;
+		}
+	}
+};
+
+// fd ile indekslenen bağlantı tablosu girdisi
+struct Connection
+{
+	Client *client;
+	size_t index; // clients vektöründeki yeri
+	int worker;   // soketin sahibi olan worker, tek thread modunda -1
+};
+
 class Server
 {
 	private:
 	    int port;
 	    std::string password;
-	    std::map<std::string, Channel*> channels;//map içinde arama yapılabilir
+	    ChannelMap channels;
+		std::vector<Channel *> channelOrder; // LIST/NAMES için ada göre sıralı görünüm
+		bool channelOrderStale;              // kanal açılıp kapandı, görünüm yeniden kurulmalı
 	    int serverFd;
-		struct pollfd pfds[BACKLOG + 1];//pollfd sayısı artırılabilir
-		int num_of_pfd;
+		Reactor *reactor;
+		std::string backend; // "auto", "epoll" ya da "poll"
 	    std::vector<Client *> clients;
+		ObjectPool<Client> clientPool;   // Client ve Channel nesneleri buradan alınır ve buraya döner
+		ObjectPool<Channel> channelPool;
+		NickMap nicks; // NICK'te eklenir, removeClient'ta silinir
+		std::vector<Connection> connections; // fd -> Connection, O(1) lookup
+		std::vector<int> pendingWrites; // bu turda outbuf'ı dolan fd'ler
+		int workerCount;
+		std::vector<Worker *> workers;
+		MessageQueue *coreInbox; // worker'lardan gelen OPEN/DATA/CLOSED
+		std::vector<std::vector<WorkerMessage> > outboxes; // worker başına SEND batch'i
+		SendQClass sendq[SendQClass::COUNT]; // bağlantı sınıfı başına gönderim kuyruğu limitleri
+		std::string cmdScratch;               // commandParser'ın tekrar kullanılan çıktıları
+		std::vector<std::string> paramScratch;
+		std::string targetScratch;            // PRIVMSG/NOTICE hedef listesinin tek elemanı
+		std::string textScratch;              // birleştirilmiş PRIVMSG metni
+		TimerWheel timers;
+		Timer trimTimer;                      // havuzda buffer varken BUFFER_TRIM_MS'de bir
+		Clock clock;                          // döngü turu başında bir kez okunur
+		time_t created;                       // RPL_CREATED'da gösterilir
+		int pingInterval;                     // saniye
+		int pingTimeout;
+		int registrationTimeout;
+		int idleTimeout;                      // saniye, 0: kapalı
+		std::vector<CommandStats> commandStats; // commandIndex() ile indekslenir
+		LoopStats loop;
+		int slowMs;
+		std::map<std::string, std::string> operators; // --oper ad -> parola
+		ConnectionStats connStats;
+		std::string metricsPath;              // --metrics, boşsa exporter kapalı
+		int metricsFd;
+		std::map<int, MetricsScrape *> scrapes; // açık scrape bağlantıları, fd ile
 	    bool running; // Server çalışma durumu için flag
 	
 	public:
 	    Server();
 	    ~Server();
 	
-		void commandParser(Client &client, std::string &message);
-		void handleClient(int index);
-		bool handleClientPollout(int index);
+		void commandParser(Client &client, const char *line, size_t len);
+		void handleClient(int fd);
+		void processInput(Client &client);
+		void feedInput(Client &client, const char *data, size_t len);
+		bool handleClientPollout(int fd);
+		void flushPending();
+		void startWorkers(int port);
+		void stopWorkers();
+		void handleWorkerMessages();
+		Client *findWorkerClient(const WorkerMessage &msg);
+		void dropExcessSendQ(Client &client, int reason);
 		void initServer(struct sockaddr_in &hints, int port);
 	    void start(int port, const char *pass);
 	    void stop(); // Server'ı güvenli şekilde durdurmak için
-	    void removeClient(int index);
-		void commandHandler(std::string cmd, std::vector<std::string> params, Client &client);
+	    void removeClient(int fd);
+		Client *addClient(int fd, int worker = -1);
+		const PoolStats &getClientPoolStats() const;
+		const PoolStats &getChannelPoolStats() const;
+		size_t bufferedBytes() const;
+		void updateClock();
+		void runTimers();
+		void keepalive(Client &client);
+		void disconnect(Client &client, const std::string &reason, DisconnectReason cause);
+		void setTimeouts(int ping, int pingTimeout, int registration); // seconds, <= 0 keeps the current one
+		void setIdleTimeout(int seconds); // 0 disables it
+		void addOper(const std::string &spec); // "name:password"
+		void setSlowThreshold(int ms);
+		void calibrateLag();
+		void endTurn(unsigned long long busy, unsigned long long waited, size_t events);
+		void slowCommand(const CommandEntry &entry, const std::vector<std::string> &params, int fd, unsigned long long elapsed);
+		void setMetricsSocket(const std::string &path);
+		void openMetrics();
+		void closeMetrics();
+		void serveMetrics(const ReactorEvent &event);
+		void answerScrape(MetricsScrape &scrape);
+		void sendScrape(MetricsScrape &scrape);
+		void closeScrape(int fd);
+		void renderMetrics(std::string &out);
+		const Clock &getClock() const;
+		Client *findClient(int fd);
+		Client *findNick(const std::string &nick);
+		Channel *findChannel(const std::string &name);
+		const std::vector<Channel *> &sortedChannels();
+		void setBackend(const std::string &name);
+		void setWorkers(int count);
+		void setSendQ(const std::string &spec);
+		const SendQClass *getSendQ() const;
+		void commandHandler(const std::string &cmd, const std::vector<std::string> &params, Client &client, size_t bytes);
 		void checkRegistration(Client &client);
-		bool nicknameCheck(std::string nickname);
+		void handleCap(const std::vector<std::string>& params, Client &client);
+		void handlePass(const std::vector<std::string>& params, Client &client);
+		void handleNick(const std::vector<std::string>& params, Client &client);
+		void handleUser(const std::vector<std::string>& params, Client &client);
+		void handlePing(const std::vector<std::string>& params, Client &client);
+		void handlePong(const std::vector<std::string>& params, Client &client);
+		void handleMotd(const std::vector<std::string>& params, Client &client);
+		void handleBack(const std::vector<std::string>& params, Client &client);
+		void leaveChannel(Channel *channel, Client &client);
 		void handleJoin(const std::vector<std::string>& params, Client &client);
 		void handlePart(const std::vector<std::string>& params, Client &client);
 		void handlePrivMsg(const std::vector<std::string>& params, Client &client);
@@ -72,13 +238,15 @@ class Server
 		void handleWho(const std::vector<std::string>& params, Client &client);
 		void handleWhois(const std::vector<std::string>& params, Client &client);
 		void handleAway(const std::vector<std::string>& params, Client &client);
+		void handleOper(const std::vector<std::string>& params, Client &client);
+		void handleStats(const std::vector<std::string>& params, Client &client);
 		
 	    //void acceptClient();
 	    //void handleClientMessage(int client_fd, const std::string& message);
 };
 
-void parseIrc(const std::string& line, std::string& cmd, std::vector<std::string>& params, std::string& trailing);
-void enqueue(std::string &outbuf, const std::string& line);
+void enqueue(Client &client, const std::string& line);
+void setNonBlocking(int fd);
 std::string to_string(int number);
 
 #endif
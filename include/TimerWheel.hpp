@@ -0,0 +1,58 @@
+#ifndef TIMERWHEEL_HPP
+# define TIMERWHEEL_HPP
+
+# include <cstddef>
+
+# define TIMER_TICK_MS 100  // wheel resolution
+# define TIMER_LEVELS 4     // 64 ticks per slot of the next level: 6.4 s, 6.8 min, 7.3 h, 19.4 days
+# define TIMER_SLOTS 64
+
+// Intrusive timer, embedded in its owner; the wheel never allocates.
+struct Timer
+{
+	Timer *next;
+	Timer **pprev;       // NULL while not scheduled
+	unsigned long long expires; // tick
+	unsigned char level;
+	unsigned char slot;
+	int kind;            // what the owner should do when it fires
+	void *data;          // owner
+
+	Timer() : next(NULL), pprev(NULL), expires(0), level(0), slot(0), kind(0), data(NULL) {}
+	bool pending() const { return pprev != NULL; }
+};
+
+// Hierarchical timing wheel: schedule() and cancel() are O(1), advance() does
+// O(1) work per elapsed tick plus one re-insert per timer when a higher level
+// slot cascades down. Nothing is ever scanned per connection, and the time to
+// the next due slot is found from per-level occupancy bitmaps.
+class TimerWheel
+{
+	private:
+		Timer *slots[TIMER_LEVELS][TIMER_SLOTS];
+		unsigned long long occupied[TIMER_LEVELS]; // bit per non-empty slot
+		Timer *expired;           // due timers not handed out yet
+		unsigned long long current; // last tick processed
+		size_t count;
+
+		TimerWheel(const TimerWheel &);
+		TimerWheel &operator=(const TimerWheel &);
+
+		void link(Timer *&head, Timer &timer);
+		void unlink(Timer &timer);
+		void place(Timer &timer);
+		void cascade(int level);
+
+	public:
+		TimerWheel();
+
+		void start(unsigned long long nowMs);
+		void schedule(Timer &timer, unsigned long long atMs); // reschedules a pending timer
+		void cancel(Timer &timer);
+		void advance(unsigned long long nowMs); // moves due timers to the expired list
+		Timer *nextExpired();                   // pops one due timer, NULL when none left
+		int timeoutMs(unsigned long long nowMs) const; // until the next due slot, -1 if empty
+		size_t size() const;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef WORKER_HPP
+# define WORKER_HPP
+
+# include <string>
+# include <vector>
+# include <pthread.h>
+# include "Reactor.hpp"
+# include "OutQueue.hpp"
+# include "SendQ.hpp"
+
+// Message passed between an I/O worker and the core (command) thread.
+struct WorkerMessage
+{
+	enum Type
+	{
+		OPEN,       // worker -> core: new connection, data = sockaddr_in
+		DATA,       // worker -> core: raw bytes read from the socket
+		CLOSED,     // worker -> core: peer hung up, fd kept open until RELEASE
+		EXCESS,     // worker -> core: SendQ limit hit, count = SendQClass::Reason
+		SEND,       // core -> worker: bytes to write
+		DISCONNECT, // core -> worker: drop what is queued, send data best-effort and close
+		RELEASE     // core -> worker: core forgot a CLOSED fd, it may be closed now
+	};
+
+	int type;
+	int fd;
+	int worker;
+	size_t count; // SEND: lines in data
+	int sendq;    // SEND: SendQClass::Id of the client
+	std::string data;
+};
+
+// Mutex protected batch queue. The first push into an empty queue writes a
+// byte to the wake pipe so the consumer's reactor returns.
+class MessageQueue
+{
+	private:
+		pthread_mutex_t lock;
+		std::vector<WorkerMessage> items;
+		int wakeFds[2];
+
+		MessageQueue(const MessageQueue &);
+		MessageQueue &operator=(const MessageQueue &);
+
+	public:
+		MessageQueue();
+		~MessageQueue();
+
+		int getWakeFd() const;
+		void push(std::vector<WorkerMessage> &batch); // empties batch
+		void drain(std::vector<WorkerMessage> &out);
+};
+
+// Owns a SO_REUSEPORT listening socket and the sockets it accepts; does all
+// recv/send for them on its own thread. IRC state stays on the core thread.
+class Worker
+{
+	private:
+		struct Conn
+		{
+			bool open;
+			bool dead;
+			bool armed;
+			bool excess; // EXCESS posted, waiting for DISCONNECT
+			OutQueue outbuf;
+		};
+
+		int id;
+		int listenFd;
+		Reactor *reactor;
+		pthread_t thread;
+		volatile bool running;
+		MessageQueue inbox;
+		MessageQueue *coreInbox;
+		const SendQClass *sendq; // core's table, read-only while running
+		std::vector<Conn *> conns; // fd -> Conn, allocated on first use
+		std::vector<WorkerMessage> outgoing;
+
+		Worker(const Worker &);
+		Worker &operator=(const Worker &);
+
+		static void *run(void *arg);
+		void loop();
+		void acceptClients();
+		void readClient(int fd);
+		void flushClient(int fd);
+		void closeClient(int fd);
+		bool checkSendQ(int fd, int cls);
+		void handleInbox();
+		void post(int type, int fd, const char *data, size_t len);
+
+	public:
+		Worker(int id, int port, const std::string &backend, MessageQueue *coreInbox,
+			const SendQClass *sendq);
+		~Worker();
+
+		void start();
+		void stop();
+		MessageQueue &getInbox();
+};
+
+#endif
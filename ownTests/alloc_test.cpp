@@ -0,0 +1,132 @@
+// Heap allocation test for the relay hot path: a framed PRIVMSG/NOTICE line is
+// parsed, dispatched and written into the recipients' output queues, which are
+// then drained as a send would. "wire" scenarios arrive as raw bytes and go
+// through the input ring first. After warm-up this must not touch the heap.
+// Build & run: make check
+#include "../include/Server.hpp"
+#include <new>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define FD_BASE 1000 // sahte fd'ler, hiçbir zaman okunmaz/yazılmaz
+#define WARMUP 1000
+#define ROUNDS 10000
+
+static bool counting = false;
+static unsigned long allocations = 0;
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+    if (counting)
+        ++allocations;
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    std::free(p);
+}
+
+static void line(Server &server, Client &from, const char *text)
+{
+    server.commandParser(from, text, std::strlen(text));
+}
+
+static void wire(Server &server, Client &from, const char *text)
+{
+    server.feedInput(from, text, std::strlen(text));
+}
+
+static void drain(Client &client)
+{
+    client.outbuf.consume(client.outbuf.size());
+}
+
+struct Scenario
+{
+    const char *name;
+    const char *line;
+    int burst; // kuyruk boşaltılmadan önce gönderilen satır
+    bool raw;  // feedInput ile, InputBuffer üzerinden
+};
+
+int main()
+{
+    Server server;
+    Client *alice = server.addClient(FD_BASE);
+    Client *bob = server.addClient(FD_BASE + 1);
+    Client *carol = server.addClient(FD_BASE + 2);
+    Client *all[] = { alice, bob, carol };
+    const char *nicks[] = { "alice", "bob", "carol" };
+
+    // kayıt ve kanal kurulumu sayılmaz; handler log'ları susturulur
+    std::streambuf *log = std::cout.rdbuf(NULL);
+    for (int i = 0; i < 3; ++i)
+    {
+        all[i]->setAuth(true);
+        std::string nick = std::string("NICK ") + nicks[i];
+        line(server, *all[i], nick.c_str());
+        line(server, *all[i], "USER u 0 * :Real Name");
+        line(server, *all[i], "JOIN #room");
+    }
+
+    Scenario scenarios[] = {
+        { "PRIVMSG user", "PRIVMSG bob :hello there, how is it going?", 1, false },
+        { "PRIVMSG user x8", "PRIVMSG bob :hello there, how is it going?", 8, false },
+        { "PRIVMSG channel", "PRIVMSG #room :hello everyone in the room", 1, false },
+        { "PRIVMSG 2 targets", "PRIVMSG bob,#room :one line, two targets", 1, false },
+        { "NOTICE user", "NOTICE bob :notice text", 1, false },
+        { "NOTICE channel", "NOTICE #room :notice text", 1, false },
+        { "wire PRIVMSG", "PRIVMSG #room :hello everyone in the room\r\n", 1, true },
+        { "wire 2 lines", "PRIVMSG bob :first\r\nPRIVMSG #room :second\r\n", 1, true },
+    };
+    size_t count = sizeof(scenarios) / sizeof(scenarios[0]);
+    unsigned long results[sizeof(scenarios) / sizeof(scenarios[0])];
+
+    for (size_t s = 0; s < count; ++s)
+    {
+        for (int round = 0; round < WARMUP + ROUNDS; ++round)
+        {
+            if (round == WARMUP)
+            {
+                allocations = 0;
+                counting = true;
+            }
+            for (int b = 0; b < scenarios[s].burst; ++b)
+            {
+                if (scenarios[s].raw)
+                    wire(server, *alice, scenarios[s].line);
+                else
+                    line(server, *alice, scenarios[s].line);
+            }
+            for (int i = 0; i < 3; ++i)
+                drain(*all[i]);
+        }
+        counting = false;
+        results[s] = allocations;
+    }
+    std::cout.rdbuf(log);
+
+    int failed = 0;
+    for (size_t s = 0; s < count; ++s)
+    {
+        double perLine = (double)results[s] / (ROUNDS * scenarios[s].burst);
+        std::printf("%-20s %8.3f allocations/line  %s\n", scenarios[s].name, perLine, results[s] ? "FAIL" : "ok");
+        failed += results[s] != 0;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+#ifndef BENCH_UTIL_HPP
+# define BENCH_UTIL_HPP
+
+// Helpers shared by the ownTests/ microbenchmarks. The Server helpers are
+// only defined when Server.hpp was included first.
+# include <ctime>
+# include <string>
+
+# define FD_BASE 1000 // sahte fd'ler, hiçbir zaman okunmaz/yazılmaz
+
+// monotonic saniye
+inline double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+# ifdef SERVER_HPP
+
+// tek komut satırı, soket ve input buffer olmadan
+inline void line(Server &server, Client &from, const std::string &text)
+{
+    server.commandParser(from, text.data(), text.size());
+}
+
+// PASS'i atlayıp NICK/USER ile kaydeder; hoş geldin satırları atılır
+inline void registerAs(Server &server, Client &client, const char *nick)
+{
+    client.setAuth(true);
+    line(server, client, std::string("NICK ") + nick);
+    line(server, client, "USER u 0 * :Bench");
+    client.outbuf.clear();
+}
+
+# endif
+
+#endif
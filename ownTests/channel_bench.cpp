@@ -0,0 +1,61 @@
+// Channel membership microbenchmark at 100/1k/10k members, 10% operators.
+// Build & run: make bench && ./channel_bench [iterations]
+// "join" is one JOIN into the channel: addClient + the 353 NAMES list + removeClient;
+// "lookup" is hasClient + isOperator for a random member (KICK/MODE/PRIVMSG checks).
+#include "../include/Channel.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 200;
+    const int sizes[] = { 100, 1000, 10000 };
+    volatile size_t sink = 0;
+
+    std::printf("%-8s %12s %12s\n", "members", "join us", "lookup ns");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        int count = sizes[s];
+        Channel channel("#bench");
+        std::vector<Client *> clients;
+        for (int i = 0; i < count; ++i)
+        {
+            Client *cl = new Client(-1);
+            char nick[16];
+            std::snprintf(nick, sizeof(nick), "user%d", i);
+            cl->setNick(nick);
+            channel.addClient(cl);
+            if (i % 10 == 0)
+                channel.addOperator(cl);
+            clients.push_back(cl);
+        }
+        Client joiner(-1);
+        joiner.setNick("joiner");
+
+        double t0 = now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            channel.addClient(&joiner);
+            sink += channel.namesList().size();
+            channel.removeClient(&joiner);
+        }
+        double join = (now() - t0) / iterations * 1e6;
+
+        long lookups = iterations * 10000;
+        t0 = now();
+        for (long i = 0; i < lookups; ++i)
+        {
+            Client *cl = clients[(i * 7919) % count];
+            sink += channel.hasClient(cl) + channel.isOperator(cl);
+        }
+        double lookup = (now() - t0) / lookups * 1e9;
+
+        std::printf("%-8d %12.1f %12.1f\n", count, join, lookup);
+        for (size_t i = 0; i < clients.size(); ++i)
+            channel.removeClient(clients[i]);
+        for (size_t i = 0; i < clients.size(); ++i)
+            delete clients[i];
+    }
+    return sink == 0;
+}
@@ -0,0 +1,76 @@
+// Dispatch microbenchmark: ns/command to find the handler for a command name.
+// Build & run: make bench && ./dispatch_bench [iterations]
+// "legacy" is the if-chain commandHandler used before the command registry.
+#include "../include/Commands.hpp"
+#include "bench_util.hpp"
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+// eski sıra: CAP, PASS, NICK, USER, PING, PONG, QUIT, kayıt kontrolü, handler zinciri
+static int legacyDispatch(const std::string &cmd)
+{
+    if (cmd == "CAP") return 1;
+    if (cmd == "PASS") return 2;
+    if (cmd == "NICK") return 3;
+    else if (cmd == "USER") return 4;
+    if (cmd == "PING") return 5;
+    else if (cmd == "PONG") return 6;
+    else if (cmd == "QUIT") return 7;
+    if (cmd == "JOIN" || cmd == "PRIVMSG" || cmd == "PART" || cmd == "NOTICE" || 
+        cmd == "MODE" || cmd == "TOPIC" || cmd == "NAMES" || cmd == "LIST" || 
+        cmd == "INVITE" || cmd == "KICK" || cmd == "WHO" || cmd == "WHOIS" || cmd == "MOTD" || cmd == "AWAY" || cmd == "BACK")
+        ;
+    else
+        return 0;
+    if (cmd == "MOTD") return 8;
+    if (cmd == "JOIN") return 9;
+    else if (cmd == "PRIVMSG") return 10;
+    else if (cmd == "PART") return 11;
+    else if (cmd == "NOTICE") return 12;
+    else if (cmd == "MODE") return 13;
+    else if (cmd == "TOPIC") return 14;
+    else if (cmd == "NAMES") return 15;
+    else if (cmd == "LIST") return 16;
+    else if (cmd == "INVITE") return 17;
+    else if (cmd == "KICK") return 18;
+    else if (cmd == "WHO") return 19;
+    else if (cmd == "WHOIS") return 20;
+    else if (cmd == "AWAY") return 21;
+    else if (cmd == "BACK") return 22;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 20000000;
+    const char *names[] = { "PRIVMSG", "NOTICE", "PING", "JOIN", "MODE", "WHOIS", "privmsg", "FOOBAR" };
+    size_t count = sizeof(names) / sizeof(names[0]);
+    volatile size_t sink = 0;
+
+    std::printf("%-10s %12s %12s\n", "command", "legacy ns", "table ns");
+    for (size_t c = 0; c < count; ++c)
+    {
+        std::string cmd = names[c];
+
+        double t0 = now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            // derleyicinin döngüden çıkarmaması için
+            __asm__ __volatile__("" : : "g"(&cmd) : "memory");
+            sink += legacyDispatch(cmd);
+        }
+        double legacy = (now() - t0) / iterations * 1e9;
+
+        t0 = now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            __asm__ __volatile__("" : : "g"(&cmd) : "memory");
+            sink += findCommand(cmd.data(), cmd.size()) != NULL;
+        }
+        double table = (now() - t0) / iterations * 1e9;
+
+        std::printf("%-10s %12.1f %12.1f\n", names[c], legacy, table);
+    }
+    return sink == 0;
+}
@@ -0,0 +1,107 @@
+// Channel fan-out microbenchmark: ns per recipient to queue one broadcast
+// block into every member's output queue, and to drain the queues again as
+// flushPending() does after a successful send.
+// Build & run: make bench && ./fanout_bench [members] [rounds]
+// Members join in random order, so walking the member list jumps between
+// Client records as it does on a long-running server; with the default 100k
+// members the records do not fit in the last-level cache. Hardware cache-miss
+// counters are read through perf_event_open when the machine exposes them.
+#include "../include/Server.hpp"
+#include "bench_util.hpp"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <cstdio>
+#include <cstdlib>
+
+// donanım sayacı yoksa (sanal makine, perf_event_paranoid) -1
+static int openMissCounter()
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static long long readCounter(int fd)
+{
+    long long value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value))
+        return -1;
+    return value;
+}
+
+int main(int argc, char **argv)
+{
+    size_t members = argc > 1 ? std::atol(argv[1]) : 100000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::streambuf *log = std::cout.rdbuf(NULL);
+    Server server;
+    std::vector<Client *> clients;
+    for (size_t i = 0; i < members; ++i)
+        clients.push_back(server.addClient(FD_BASE + i));
+    std::cout.rdbuf(log);
+
+    std::srand(42);
+    for (size_t i = members; i > 1; --i)
+        std::swap(clients[i - 1], clients[std::rand() % i]);
+    Channel channel("#fanout");
+    for (size_t i = 0; i < members; ++i)
+        channel.addClient(clients[i]);
+    const std::vector<Member> &list = channel.getMembers();
+
+    SharedMessage *msg = SharedMessage::create(":sender!u@h PRIVMSG #fanout :hello everyone in the channel\r\n");
+    int counter = openMissCounter();
+    double send = 0, drain = 0;
+    long long sendMisses = 0, drainMisses = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+        long long c0 = readCounter(counter);
+        double t0 = now();
+        channel.sendMsg(msg, NULL);
+        double t1 = now();
+        long long c1 = readCounter(counter);
+        // flushPending'in client başına baktıkları; soket yerine consume
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            Client *client = list[i].client;
+            if (client->getSendQExcess())
+                continue;
+            client->outbuf.consume(client->outbuf.size());
+            if (client->outbuf.empty() == client->isWriteArmed())
+                client->setWriteArmed(false);
+        }
+        double t2 = now();
+        long long c2 = readCounter(counter);
+        if (r == 0)
+            continue; // ilk tur kuyruk vektörlerini büyütür
+        send += t1 - t0;
+        drain += t2 - t1;
+        sendMisses += c1 - c0;
+        drainMisses += c2 - c1;
+    }
+    msg->release();
+
+    double per = (double)members * (rounds - 1);
+    std::printf("sizeof(Client) %lu bytes, %lu members, %d rounds\n",
+        (unsigned long)sizeof(Client), (unsigned long)members, rounds - 1);
+    std::printf("%-8s %12s %16s\n", "", "ns/member", "misses/member");
+    if (counter < 0)
+    {
+        std::printf("%-8s %12.1f %16s\n", "send", send / per * 1e9, "n/a");
+        std::printf("%-8s %12.1f %16s\n", "drain", drain / per * 1e9, "n/a");
+    }
+    else
+    {
+        std::printf("%-8s %12.1f %16.2f\n", "send", send / per * 1e9, sendMisses / per);
+        std::printf("%-8s %12.1f %16.2f\n", "drain", drain / per * 1e9, drainMisses / per);
+        close(counter);
+    }
+    for (size_t i = 0; i < members; ++i)
+        channel.removeClient(clients[i]);
+    return 0;
+}
@@ -0,0 +1,507 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+IRC Server Benchmarks
+---------------------
+Starts ./ircserv itself (one instance per backend/configuration) and measures
+how it behaves under load. Each benchmark is a subcommand.
+
+USAGE
+-----
+python3 irc_bench.py idle --binary ./ircserv --backends epoll,poll --idle 0,1000,10000 [--partial]
+
+python3 irc_bench.py scale --binary ./ircserv --workers 0,1,2,4 --procs 4 --conns 25
+
+python3 irc_bench.py backends --binary ./ircserv --backends uring,epoll,poll
+
+python3 irc_bench.py fanout --binary ./ircserv --members 200 --messages 5000 --size 400
+
+python3 irc_bench.py stalled --binary ./ircserv --members 20 --duration 10
+
+python3 irc_bench.py storm --binary ./ircserv --procs 4 --batch 20 --duration 5
+
+Benchmarks:
+  idle   Loop cost vs. idle-connection count: PING/PONG round-trip latency of one
+         active client and server CPU time while N idle sockets stay connected,
+         plus server RSS growth per idle socket. With --partial every idle socket
+         first sends half a line, so the server has to hold input for each.
+  scale  Channel throughput vs. --workers: every client joins one channel, one
+         client per load process floods PRIVMSG, all clients count what they get.
+  backends
+         The same channel flood once per event backend (uring/epoll/poll); reports
+         delivered messages per second and server CPU time per delivered message.
+  fanout Large-channel broadcast: members stop reading while one client sends
+         --messages lines, server RSS growth is recorded, then members drain the
+         backlog and the delivery rate is measured.
+  stalled
+         One member of a busy channel never reads while the others do; samples
+         server RSS during the flood and checks the stalled client is dropped
+         with "Excess SendQ" (pass --sendq '' to fanout for pre-SendQ builds).
+  storm  Reconnect storm: each load process opens --batch connections at a time,
+         and each one registers, JOINs a channel of its own, QUITs and closes, so
+         every cycle creates and frees one Client and one Channel. Reports cycles
+         per second, server CPU time per cycle and server RSS growth.
+
+Notes:
+- Idle connections are plain TCP sockets that never send anything (or only an
+  unterminated line with --partial).
+- RLIMIT_NOFILE is raised for both this script and the spawned server; very large
+  --idle values may still need `ulimit -n` to be raised by hand.
+"""
+
+import argparse
+import multiprocessing
+import os
+import selectors
+import resource
+import socket
+import subprocess
+import sys
+import time
+
+# ----------------------------- Utility -------------------------------------
+def raise_nofile():
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    if soft < hard:
+        resource.setrlimit(resource.RLIMIT_NOFILE, (hard, hard))
+    return resource.getrlimit(resource.RLIMIT_NOFILE)[0]
+
+def cpu_seconds(pid):
+    """utime + stime of a process, in seconds (linux /proc)."""
+    try:
+        with open(f"/proc/{pid}/stat") as f:
+            fields = f.read().rsplit(")", 1)[1].split()
+        ticks = os.sysconf(os.sysconf_names["SC_CLK_TCK"])
+        return (int(fields[11]) + int(fields[12])) / ticks
+    except (OSError, IndexError):
+        return float("nan")
+
+class ServerProcess:
+    """Runs ircserv with the given extra arguments on a free port."""
+    def __init__(self, binary, port, password, extra):
+        self.binary = binary
+        self.port = port
+        self.password = password
+        self.extra = list(extra)
+        self.proc = None
+
+    def __enter__(self):
+        self.proc = subprocess.Popen(
+            [self.binary, str(self.port), self.password] + self.extra,
+            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+            preexec_fn=raise_nofile)
+        deadline = time.time() + 5.0
+        while time.time() < deadline:
+            try:
+                socket.create_connection(("127.0.0.1", self.port), timeout=0.2).close()
+                return self
+            except OSError:
+                time.sleep(0.05)
+        self.proc.kill()
+        raise RuntimeError(f"server did not start: {' '.join(self.extra)}")
+
+    def __exit__(self, *exc):
+        self.proc.terminate()
+        try:
+            self.proc.wait(timeout=3)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+
+    @property
+    def pid(self):
+        return self.proc.pid
+
+class LineClient:
+    """Tiny blocking IRC client used by the benchmarks."""
+    def __init__(self, port, timeout=5.0, rcvbuf=None):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        if rcvbuf:
+            # must be set before connect to bound the advertised window
+            self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, rcvbuf)
+        self.sock.settimeout(timeout)
+        self.sock.connect(("127.0.0.1", port))
+        self.buf = b""
+
+    def send(self, line):
+        self.sock.sendall(line.encode() + b"\r\n")
+
+    def send_many(self, lines):
+        self.sock.sendall(b"".join(l.encode() + b"\r\n" for l in lines))
+
+    def read_line(self):
+        while b"\n" not in self.buf:
+            chunk = self.sock.recv(65536)
+            if not chunk:
+                raise ConnectionError("server closed the connection")
+            self.buf += chunk
+        line, self.buf = self.buf.split(b"\n", 1)
+        return line.decode(errors="ignore").rstrip("\r")
+
+    def wait_for(self, token):
+        while True:
+            line = self.read_line()
+            if token in line:
+                return line
+
+    def register(self, password, nick):
+        self.send_many([f"PASS {password}", f"NICK {nick}", f"USER {nick} h s :{nick}"])
+        self.wait_for(" 001 ")
+
+    def close(self):
+        self.sock.close()
+
+def rss_kib(pid):
+    """Resident set size of a process in KiB (linux /proc)."""
+    try:
+        with open(f"/proc/{pid}/status") as f:
+            for line in f:
+                if line.startswith("VmRSS:"):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return 0
+
+def open_idle(port, count, partial=False):
+    socks = []
+    for i in range(count):
+        s = socket.create_connection(("127.0.0.1", port), timeout=5.0)
+        if partial:
+            s.sendall(f"PRIVMSG #idle :unterminated line from idle client {i}".encode())
+        socks.append(s)
+    return socks
+
+def print_table(headers, rows):
+    widths = [max(len(str(h)), *(len(str(r[i])) for r in rows)) for i, h in enumerate(headers)]
+    print("  ".join(str(h).rjust(w) for h, w in zip(headers, widths)))
+    for r in rows:
+        print("  ".join(str(v).rjust(w) for v, w in zip(r, widths)))
+
+# ----------------------------- Benchmarks ----------------------------------
+def bench_idle(args):
+    rows = []
+    for backend in args.backends.split(","):
+        for idle in [int(x) for x in args.idle.split(",")]:
+            with ServerProcess(args.binary, args.port, args.password, ["--backend", backend]) as srv:
+                rss0 = rss_kib(srv.pid)
+                idle_socks = open_idle(args.port, idle, args.partial)
+                active = LineClient(args.port)
+                active.register(args.password, "bench")
+                time.sleep(0.2)
+                rss = rss_kib(srv.pid) - rss0
+
+                cpu0, t0 = cpu_seconds(srv.pid), time.perf_counter()
+                for i in range(args.pings):
+                    active.send(f"PING t{i}")
+                    active.wait_for(f"t{i}")
+                elapsed = time.perf_counter() - t0
+                cpu = cpu_seconds(srv.pid) - cpu0
+
+                active.close()
+                for s in idle_socks:
+                    s.close()
+            rows.append((backend, idle, f"{elapsed / args.pings * 1e6:.1f}",
+                         f"{cpu / elapsed * 100:.0f}%",
+                         f"{rss / idle:.2f}" if idle else "-"))
+    print_table(("backend", "idle conns", "rtt us/PING", "server cpu", "rss KiB/conn"), rows)
+
+def _scale_load(port, password, index, conns, duration, barrier, results):
+    """One load process: `conns` members of #bench, the first one also floods."""
+    clients = []
+    for i in range(conns):
+        cl = LineClient(port)
+        cl.register(password, f"p{index}c{i}")
+        cl.send("JOIN #bench")
+        cl.wait_for(" 366 ")
+        cl.sock.setblocking(False)
+        clients.append(cl)
+    barrier.wait()
+
+    sel = selectors.DefaultSelector()
+    for cl in clients:
+        sel.register(cl.sock, selectors.EVENT_READ, cl)
+    burst = b"".join(f"PRIVMSG #bench :load {index} {n}\r\n".encode() for n in range(50))
+    sender = clients[0].sock
+    pending = b""
+    received = 0
+    end = time.perf_counter() + duration
+    while time.perf_counter() < end:
+        if not pending:
+            pending = burst
+        try:
+            pending = pending[sender.send(pending):]
+        except BlockingIOError:
+            pass
+        for key, _ in sel.select(timeout=0.001):
+            try:
+                chunk = key.fileobj.recv(262144)
+            except BlockingIOError:
+                continue
+            received += chunk.count(b" PRIVMSG ")
+    results.put(received)
+    for cl in clients:
+        cl.close()
+
+def _run_flood(args, extra):
+    """Runs the channel flood against a fresh server; returns (msg/s, server cpu s)."""
+    with ServerProcess(args.binary, args.port, args.password, extra) as srv:
+        barrier = multiprocessing.Barrier(args.procs)
+        results = multiprocessing.Queue()
+        procs = [multiprocessing.Process(target=_scale_load,
+                                         args=(args.port, args.password, i, args.conns,
+                                               args.duration, barrier, results))
+                 for i in range(args.procs)]
+        for p in procs:
+            p.start()
+        cpu0 = cpu_seconds(srv.pid)
+        total = sum(results.get(timeout=args.duration + 60) for _ in procs)
+        cpu = cpu_seconds(srv.pid) - cpu0
+        for p in procs:
+            p.join()
+    return total / args.duration, cpu
+
+def bench_scale(args):
+    rows = []
+    base = None
+    for workers in [int(x) for x in args.workers.split(",")]:
+        rate, _ = _run_flood(args, ["--workers", str(workers)])
+        base = base or rate
+        rows.append((workers, args.procs * args.conns, f"{rate:,.0f}", f"{rate / base:.2f}x"))
+    print_table(("workers", "members", "delivered msg/s", "vs first"), rows)
+
+def bench_backends(args):
+    rows = []
+    for backend in args.backends.split(","):
+        rate, cpu = _run_flood(args, ["--backend", backend] + (["--log", args.log] if args.log else []))
+        delivered = rate * args.duration
+        rows.append((backend, args.procs * args.conns, f"{rate:,.0f}",
+                     f"{cpu / delivered * 1e6:.2f}" if delivered else "-"))
+    print_table(("backend", "members", "delivered msg/s", "server cpu us/msg"), rows)
+
+def bench_fanout(args):
+    extra = ["--sendq", args.sendq] if args.sendq else []
+    with ServerProcess(args.binary, args.port, args.password, extra) as srv:
+        members = []
+        for i in range(args.members):
+            cl = LineClient(args.port, rcvbuf=4096)
+            cl.register(args.password, f"m{i}")
+            cl.send("JOIN #fan")
+            cl.wait_for(" 366 ")
+            members.append(cl)
+        sender = LineClient(args.port)
+        sender.register(args.password, "sender")
+        sender.send("JOIN #fan")
+        sender.wait_for(" 366 ")
+        time.sleep(0.2)
+
+        # phase 1: members do not read, everything piles up in the server
+        rss0, cpu0 = rss_kib(srv.pid), cpu_seconds(srv.pid)
+        text = "x" * args.size
+        t0 = time.perf_counter()
+        sender.send_many([f"PRIVMSG #fan :{n} {text}" for n in range(args.messages)] + ["PING done"])
+        sender.wait_for("done")
+        queued = time.perf_counter() - t0
+        rss1 = rss_kib(srv.pid)
+
+        # phase 2: members drain their backlog
+        sel = selectors.DefaultSelector()
+        for cl in members:
+            cl.sock.setblocking(False)
+            sel.register(cl.sock, selectors.EVENT_READ, cl)
+        expected = args.members * args.messages
+        received = 0
+        carry = {}
+        t1 = time.perf_counter()
+        deadline = t1 + 120
+        while received < expected and time.perf_counter() < deadline:
+            for key, _ in sel.select(timeout=0.5):
+                try:
+                    chunk = key.fileobj.recv(262144)
+                except BlockingIOError:
+                    continue
+                # keep a short tail so a marker split across two reads is still seen once
+                data = carry.get(key.fd, b"") + chunk
+                received += data.count(b" PRIVMSG ")
+                carry[key.fd] = data[-8:]
+        drained = time.perf_counter() - t1
+        cpu = cpu_seconds(srv.pid) - cpu0
+        for cl in members + [sender]:
+            cl.close()
+
+    print_table(("members", "msgs x bytes", "rss growth", "fan-out time", "drain msg/s",
+                 "server cpu us/msg", "delivered"),
+                [(args.members, f"{args.messages}x{args.size}", f"{(rss1 - rss0) / 1024:.1f} MiB",
+                  f"{queued * 1e3:.0f} ms", f"{received / drained:,.0f}",
+                  f"{cpu / max(received, 1) * 1e6:.2f}", f"{received}/{expected}")])
+
+def bench_stalled(args):
+    with ServerProcess(args.binary, args.port, args.password, []) as srv:
+        stalled = LineClient(args.port, rcvbuf=4096)
+        stalled.register(args.password, "stalled")
+        stalled.send("JOIN #busy")
+        stalled.wait_for(" 366 ")
+        readers = []
+        for i in range(args.members):
+            cl = LineClient(args.port)
+            cl.register(args.password, f"r{i}")
+            cl.send("JOIN #busy")
+            cl.wait_for(" 366 ")
+            cl.sock.setblocking(False)
+            readers.append(cl)
+        sender = readers[0].sock
+        time.sleep(0.2)
+
+        sel = selectors.DefaultSelector()
+        for cl in readers:
+            sel.register(cl.sock, selectors.EVENT_READ, cl)
+        burst = b"".join(f"PRIVMSG #busy :{n} {'x' * args.size}\r\n".encode() for n in range(50))
+        pending = b""
+        received = 0
+        quit_seen = False
+        rss0 = rss_kib(srv.pid)
+        samples = []
+        start = time.perf_counter()
+        next_sample = start
+        while time.perf_counter() - start < args.duration:
+            if not pending:
+                pending = burst
+            try:
+                pending = pending[sender.send(pending):]
+            except BlockingIOError:
+                pass
+            for key, _ in sel.select(timeout=0.001):
+                try:
+                    chunk = key.fileobj.recv(262144)
+                except BlockingIOError:
+                    continue
+                received += chunk.count(b" PRIVMSG ")
+                quit_seen = quit_seen or b"Excess SendQ" in chunk
+            if time.perf_counter() >= next_sample:
+                samples.append(rss_kib(srv.pid))
+                next_sample += args.duration / 10
+        elapsed = time.perf_counter() - start
+        rss1 = rss_kib(srv.pid)
+
+        # the stalled socket is closed by the server once its SendQ overflows
+        stalled.sock.settimeout(0.5)
+        dropped = False
+        try:
+            while True:
+                if not stalled.sock.recv(1 << 20):
+                    dropped = True
+                    break
+        except (socket.timeout, OSError):
+            pass
+        for cl in readers + [stalled]:
+            cl.close()
+
+    print("rss MiB over time: " + " ".join(f"{(r - rss0) / 1024:.1f}" for r in samples))
+    print_table(("members", "delivered msg/s", "rss growth", "peak", "stalled dropped", "QUIT seen"),
+                [(args.members + 1, f"{received / elapsed:,.0f}", f"{(rss1 - rss0) / 1024:.1f} MiB",
+                  f"{(max(samples + [rss1]) - rss0) / 1024:.1f} MiB", "yes" if dropped else "no",
+                  "yes" if quit_seen else "no")])
+
+def _storm_load(port, password, index, batch, duration, barrier, results):
+    """One load process: connect/register/join/quit cycles, `batch` at a time."""
+    barrier.wait()
+    cycles = 0
+    end = time.perf_counter() + duration
+    while time.perf_counter() < end:
+        clients = [LineClient(port) for _ in range(batch)]
+        for n, cl in enumerate(clients):
+            nick = f"s{index}x{cycles + n}"
+            cl.send_many([f"PASS {password}", f"NICK {nick}", f"USER {nick} h s :{nick}",
+                          f"JOIN #{nick}", "QUIT :storm"])
+        for cl in clients:
+            cl.wait_for("ERROR :Closing Link")
+            cl.close()
+        cycles += batch
+    results.put(cycles)
+
+def bench_storm(args):
+    with ServerProcess(args.binary, args.port, args.password, []) as srv:
+        barrier = multiprocessing.Barrier(args.procs)
+        results = multiprocessing.Queue()
+        procs = [multiprocessing.Process(target=_storm_load,
+                                         args=(args.port, args.password, i, args.batch,
+                                               args.duration, barrier, results))
+                 for i in range(args.procs)]
+        rss0 = rss_kib(srv.pid)
+        cpu0 = cpu_seconds(srv.pid)
+        start = time.perf_counter()
+        for p in procs:
+            p.start()
+        cycles = sum(results.get(timeout=args.duration + 60) for _ in procs)
+        elapsed = time.perf_counter() - start
+        cpu = cpu_seconds(srv.pid) - cpu0
+        for p in procs:
+            p.join()
+        time.sleep(0.2)  # let the last closes be processed
+        rss1 = rss_kib(srv.pid)
+    print_table(("procs", "batch", "cycles", "cycles/s", "server cpu us/cycle", "rss growth"),
+                [(args.procs, args.batch, cycles, f"{cycles / elapsed:,.0f}",
+                  f"{cpu / cycles * 1e6:.1f}" if cycles else "-", f"{(rss1 - rss0) / 1024:.1f} MiB")])
+
+# --------------------------- Main ------------------------------------------
+def parse_args():
+    p = argparse.ArgumentParser(description="IRC server benchmarks")
+    p.add_argument("--binary", default="./ircserv")
+    p.add_argument("--port", type=int, default=6697)
+    p.add_argument("--password", default="pass")
+    sub = p.add_subparsers(dest="bench", required=True)
+
+    b = sub.add_parser("idle", help="loop cost vs. idle-connection count")
+    b.add_argument("--backends", default="epoll,poll")
+    b.add_argument("--idle", default="0,100,1000")
+    b.add_argument("--pings", type=int, default=2000)
+    b.add_argument("--partial", action="store_true",
+                   help="idle sockets send an unterminated line first")
+    b.set_defaults(func=bench_idle)
+
+    b = sub.add_parser("scale", help="channel throughput vs. worker count")
+    b.add_argument("--workers", default="0,1,2,4")
+    b.add_argument("--procs", type=int, default=4, help="load generator processes")
+    b.add_argument("--conns", type=int, default=25, help="channel members per process")
+    b.add_argument("--duration", type=float, default=5.0)
+    b.set_defaults(func=bench_scale)
+
+    b = sub.add_parser("backends", help="channel throughput per event backend")
+    b.add_argument("--backends", default="uring,epoll,poll")
+    b.add_argument("--procs", type=int, default=2, help="load generator processes")
+    b.add_argument("--conns", type=int, default=50, help="channel members per process")
+    b.add_argument("--duration", type=float, default=5.0)
+    b.add_argument("--log", default="", help="server --log spec, e.g. cmd=debug ('' for the default)")
+    b.set_defaults(func=bench_backends)
+
+    b = sub.add_parser("fanout", help="memory and drain rate of a large-channel broadcast")
+    b.add_argument("--members", type=int, default=200)
+    b.add_argument("--messages", type=int, default=5000)
+    b.add_argument("--size", type=int, default=400, help="PRIVMSG text length")
+    b.add_argument("--sendq", default="user=1073741824:100000000",
+                   help="server --sendq, large so members are not dropped ('' for none)")
+    b.set_defaults(func=bench_fanout)
+
+    b = sub.add_parser("stalled", help="server memory with one stalled reader in a busy channel")
+    b.add_argument("--members", type=int, default=20, help="members that keep reading")
+    b.add_argument("--size", type=int, default=400, help="PRIVMSG text length")
+    b.add_argument("--duration", type=float, default=10.0)
+    b.set_defaults(func=bench_stalled)
+
+    b = sub.add_parser("storm", help="connect/register/join/quit cycles per second")
+    b.add_argument("--procs", type=int, default=4, help="load generator processes")
+    b.add_argument("--batch", type=int, default=20, help="concurrent connections per process")
+    b.add_argument("--duration", type=float, default=5.0)
+    b.set_defaults(func=bench_storm)
+    return p.parse_args()
+
+def main():
+    args = parse_args()
+    limit = raise_nofile()
+    if args.bench == "idle" and max(int(x) for x in args.idle.split(",")) + 16 > limit:
+        print(f"warning: RLIMIT_NOFILE is {limit}, large --idle values will fail", file=sys.stderr)
+    args.func(args)
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        print("Interrupted.")
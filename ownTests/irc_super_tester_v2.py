@@ -26,6 +26,7 @@ from __future__ import annotations
 import asyncio
 import argparse
 import re
+import socket
 import sys
 import time
 from dataclasses import dataclass, field
@@ -166,6 +167,8 @@ class TestContext:
     port: int
     password: Optional[str]
     verbose: bool
+    metrics: Optional[str] = None
+    idle_timeout: int = 0
     clients: Dict[str, IRCClient] = field(default_factory=dict)
 
     async def new_client(self, name: str) -> IRCClient:
@@ -253,6 +256,27 @@ async def test_successful_registration(ctx: TestContext):
     await drain_until_silent(a)
     await a.close()
 
+async def test_slow_registration_idle_timeout(ctx: TestContext):
+    if not ctx.idle_timeout:
+        print(c("  (skipped: no --idle-timeout given)", "YELLOW"))
+        return
+    # USER arrives after the idle timeout has passed; the idle clock starts at registration
+    a = await ctx.new_client("SR1")
+    if a.password is not None:
+        a.send("PASS", a.password)
+    a.send("NICK", "slowreg")
+    await a.drain()
+    await asyncio.sleep(ctx.idle_timeout + 0.5)
+    a.send("USER", "slowu", "host", "server", trailing="Slow")
+    await a.drain()
+    assert await a.expect_numeric("001", timeout=2.0), "Expected 001 after a slow registration"
+    a.send("PING", "slow")
+    await a.drain()
+    assert await a.expect_regex(r"PONG .*slow", timeout=1.0), "server dropped the client that registered slowly"
+    # with no PRIVMSG the idle timeout still applies from registration on
+    assert await a.expect_regex(r"Idle timeout", timeout=ctx.idle_timeout + 2.0), "idle timeout did not fire after registration"
+    await a.close()
+
 async def test_double_nick_collision(ctx: TestContext):
     a = await ctx.new_client("N1")
     b = await ctx.new_client("N2")
@@ -263,6 +287,38 @@ async def test_double_nick_collision(ctx: TestContext):
     assert await b.expect_numeric("433", timeout=1.0), "Expected 433 ERR_NICKNAMEINUSE"
     await a.close(); await b.close()
 
+async def test_nick_casemapping(ctx: TestContext):
+    a = await ctx.new_client("M1")
+    b = await ctx.new_client("M2")
+    await register_minimal(a, "Gus[1]")
+    await register_minimal(b, "hana")
+    # RFC 1459: "[]" are the upper-case forms of "{}", so this is the same nick
+    b.send("NICK", "gus{1}")
+    await b.drain()
+    assert await b.expect_numeric("433", timeout=1.0), "Expected 433 for a case-mapped nick collision"
+    b.send("PRIVMSG", "GUS{1}", trailing="casemapped")
+    await b.drain()
+    assert await a.expect_regex(r"PRIVMSG GUS\{1\} :casemapped", timeout=1.0), "PRIVMSG should reach the case-mapped nick"
+    # WHO and an INVITE by a case-mapped nick match the same client
+    b.send("WHO", "GUS{1}")
+    await b.drain()
+    assert await b.expect_numeric("352", contains="Gus[1]", timeout=1.0), "WHO should find the case-mapped nick"
+    b.send("JOIN", "#casemap")
+    b.send("MODE", "#casemap", "+i")
+    b.send("INVITE", "gus{1}", "#casemap")
+    await b.drain()
+    assert await b.expect_numeric("341", timeout=1.0), "INVITE by a case-mapped nick should succeed"
+    a.send("JOIN", "#casemap")
+    await a.drain()
+    assert await a.expect_numeric("366", timeout=1.0), "Invited client should be able to join (no 473)"
+    # quitting frees the nick for everyone
+    await a.close()
+    await asyncio.sleep(0.2)
+    b.send("NICK", "gus[1]")
+    await b.drain()
+    assert not await b.expect_numeric("433", timeout=0.5), "Nick of a disconnected client should be free"
+    await b.close()
+
 # === Basic channel ops ===
 async def test_join_and_names(ctx: TestContext):
     a = await ctx.new_client("C1")
@@ -283,6 +339,27 @@ async def test_join_and_names(ctx: TestContext):
     assert await a.expect_numeric("324", timeout=1.0), "Expected 324 RPL_CHANNELMODEIS"
     await a.close()
 
+async def test_channel_casemapping(ctx: TestContext):
+    a = await ctx.new_client("CM1")
+    b = await ctx.new_client("CM2")
+    await register_minimal(a, "wade")
+    await register_minimal(b, "xena")
+    a.send("JOIN", "#Case[Room]")
+    await a.drain()
+    await a.expect_numeric("366", timeout=1.0)
+    # same channel under RFC 1459 casemapping; replies keep the creator's spelling
+    b.send("JOIN", "#case{room}")
+    await b.drain()
+    assert await b.expect_regex(r"xena!\S+ JOIN #Case\[Room\]", timeout=1.0), "JOIN should use the channel's own name"
+    assert await b.expect_regex(r" 353 xena = #Case\[Room\] :.*wade", timeout=1.0), "Both should be in one channel"
+    b.send("PRIVMSG", "#CASE{ROOM}", trailing="folded")
+    await b.drain()
+    assert await a.expect_regex(r"PRIVMSG #Case\[Room\] :folded", timeout=1.0), "PRIVMSG should reach the case-mapped channel"
+    b.send("LIST")
+    await b.drain()
+    assert await b.expect_regex(r" 322 xena #Case\[Room\] 2 ", timeout=1.0), "LIST should show one channel with 2 users"
+    await a.close(); await b.close()
+
 # === Messaging & common errors ===
 async def test_privmsg_channel_and_user(ctx: TestContext):
     a = await ctx.new_client("P1")
@@ -371,6 +448,17 @@ async def test_modes_topic_protection(ctx: TestContext):
     await b.drain()
     assert await b.expect_numeric("482", timeout=1.0), "Removing +o should block topic"
 
+    # +v is a member prefix only: shown in NAMES, grants no op rights
+    a.send("MODE", "#m", "+v", "user")
+    await a.drain()
+    assert await b.expect_regex(r"MODE #m \+v user", timeout=1.0), "MODE +v should be broadcast"
+    a.send("NAMES", "#m")
+    await a.drain()
+    assert await a.expect_regex(r" 353 ops = #m :.*\+user", timeout=1.0), "Voiced member should carry the + prefix"
+    b.send("TOPIC", "#m", trailing="voice is not op")
+    await b.drain()
+    assert await b.expect_numeric("482", timeout=1.0), "+v should not allow topic change"
+
     await a.close(); await b.close()
 
 async def test_modes_unknown_and_errors(ctx: TestContext):
@@ -466,6 +554,30 @@ async def test_part_quit_visibility(ctx: TestContext):
 
     await a.close()
 
+async def test_join_zero_parts_all(ctx: TestContext):
+    a = await ctx.new_client("JZ1")
+    b = await ctx.new_client("JZ2")
+    await register_minimal(a, "uma")
+    await register_minimal(b, "vic")
+    a.send("JOIN", "#jz1,#jz2")
+    b.send("JOIN", "#jz2")
+    await a.drain(); await b.drain()
+    await b.expect_numeric("366", timeout=1.0)
+
+    # JOIN 0 leaves every channel with a PART each
+    a.send("JOIN", "0")
+    await a.drain()
+    assert await a.expect_regex(r"PART #jz1", timeout=1.0), "JOIN 0 should PART #jz1"
+    assert await b.expect_regex(r"uma!\S+ PART #jz2", timeout=1.0), "Peers should see the PART from JOIN 0"
+
+    b.send("WHOIS", "uma")
+    await b.drain()
+    assert await b.expect_numeric("318", timeout=1.0), "Expected 318 RPL_ENDOFWHOIS"
+    b.send("NAMES", "#jz2")
+    await b.drain()
+    assert await b.expect_regex(r" 353 vic = #jz2 :@?vic\s*$", timeout=1.0), "uma should be gone from #jz2"
+    await a.close(); await b.close()
+
 # === WHOIS, PING/PONG ===
 async def test_whois_ping(ctx: TestContext):
     a = await ctx.new_client("W1")
@@ -474,11 +586,82 @@ async def test_whois_ping(ctx: TestContext):
     await a.drain()
     assert await a.expect_regex(r"\s(311|318)\s|RPL_WHOIS", timeout=1.5), "Expected WHOIS reply (311 + 318 typical)"
 
+    # 319 lists the channels by name, whatever order they were joined in
+    a.send("JOIN", "#wz,#wa,#wm")
+    await a.drain()
+    await drain_until_silent(a)
+    a.send("WHOIS", "zara")
+    await a.drain()
+    assert await a.expect_regex(r" 319 zara zara :@#wa @#wm @#wz\s*$", timeout=1.0), "Expected 319 sorted by channel name"
+
     a.send("PING", "server")
     await a.drain()
     assert await a.expect_command("PONG", timeout=1.0), "Expected PONG"
     await a.close()
 
+async def test_stats_needs_oper(ctx: TestContext):
+    a = await ctx.new_client("ST1")
+    await register_minimal(a, "yuri")
+    a.send("STATS", "m")
+    await a.drain()
+    assert await a.expect_numeric("481", timeout=1.0), "STATS should need operator status (481)"
+    # the tester starts the server without --oper
+    a.send("OPER", "yuri", "guess")
+    await a.drain()
+    assert await a.expect_regex(r" (491|464) yuri ", timeout=1.0), "OPER with bad credentials should fail"
+    a.send("STATS", "m")
+    await a.drain()
+    assert await a.expect_numeric("481", timeout=1.0), "Failed OPER must not grant STATS"
+    await a.close()
+
+async def scrape_metrics(path: str, request: bytes) -> bytes:
+    r, w = await asyncio.open_unix_connection(path)
+    if request:
+        w.write(request)
+    else:
+        w.write_eof()
+    await w.drain()
+    data = await asyncio.wait_for(r.read(), timeout=2.0)
+    w.close()
+    return data
+
+def metric_value(text: str, sample: str) -> Optional[float]:
+    for line in text.splitlines():
+        if line.startswith(sample + " "):
+            return float(line.split()[-1])
+    return None
+
+async def test_metrics_socket(ctx: TestContext):
+    if not ctx.metrics:
+        print(c("  (skipped: no --metrics socket given)", "YELLOW"))
+        return
+    before = (await scrape_metrics(ctx.metrics, b"")).decode()
+    a = await ctx.new_client("MX1")
+    await register_minimal(a, "metra")
+    a.send("JOIN", "#metrics")
+    await a.drain()
+    assert await a.expect_numeric("366", timeout=1.0), "JOIN failed"
+
+    reply = (await scrape_metrics(ctx.metrics, b"GET /metrics HTTP/1.1\r\nHost: irc\r\n\r\n")).decode()
+    head, _, body = reply.partition("\r\n\r\n")
+    assert head.startswith("HTTP/1.0 200"), f"unexpected status: {head.splitlines()[:1]}"
+    assert f"Content-Length: {len(body.encode())}" in head, "Content-Length does not match the body"
+    assert "# TYPE irc_command_calls_total counter" in body, "missing TYPE line"
+    assert (metric_value(body, "irc_clients_registered") or 0) >= 1, "registered client not counted"
+    assert (metric_value(body, "irc_channels") or 0) >= 1, "channel not counted"
+    joins = 'irc_command_calls_total{command="JOIN"}'
+    assert metric_value(body, joins) > metric_value(before, joins), "JOIN not counted"
+    accepted = "irc_connections_accepted_total"
+    assert metric_value(body, accepted) > metric_value(before, accepted), "accept not counted"
+
+    missing = (await scrape_metrics(ctx.metrics, b"GET /nope HTTP/1.0\r\n\r\n")).decode()
+    assert missing.startswith("HTTP/1.0 404"), "unknown path should be 404"
+    # the IRC side still answers after the scrapes
+    a.send("PING", "after-metrics")
+    await a.drain()
+    assert await a.expect_regex(r"PONG .*after-metrics", timeout=1.0), "server stopped answering after a scrape"
+    await a.close()
+
 # === Robustness: partial commands, slow readers, abrupt close ===
 async def test_partial_command_assembly(ctx: TestContext):
     a = await ctx.new_client("PC1")
@@ -503,6 +686,34 @@ async def test_partial_command_assembly(ctx: TestContext):
     assert await b.expect_command("PRIVMSG", timeout=1.0), "Server must assemble fragmented lines"
     await a.close(); await b.close()
 
+async def test_line_limit_and_pipelining(ctx: TestContext):
+    a = await ctx.new_client("LONG")
+    await register_minimal(a, "longline")
+    await drain_until_silent(a)
+
+    # 600 bytes without tags is over the 512-byte limit: 417, connection stays usable
+    a.send_raw("PRIVMSG longline :" + "y" * 600)
+    await a.drain()
+    assert await a.expect_numeric("417", timeout=1.0), "Over-long line must get 417"
+
+    # a line that never ends is discarded up to its newline, the next one still works
+    a.send_raw_bytes_no_crlf(b"PRIVMSG longline :" + b"z" * 20000)
+    a.send_raw_bytes_no_crlf(b"\r\nPING after-flood\r\n")
+    await a.drain()
+    assert await a.expect_regex(r"PONG.*after-flood", timeout=2.0), "Line after an over-long one must be parsed"
+
+    # a tagged line may use the tag allowance, and the tags are skipped by the parser
+    a.send_raw("@label=" + "t" * 3000 + " PING tagged")
+    await a.drain()
+    assert await a.expect_regex(r"PONG.*tagged", timeout=1.0), "Tags must not count against the 512-byte limit"
+
+    # a pipelined burst in one write is processed in order
+    burst = "".join(f"PING burst{i}\r\n" for i in range(2000))
+    a.send_raw_bytes_no_crlf(burst.encode())
+    await a.drain()
+    assert await a.expect_regex(r"PONG.*burst1999\b", timeout=5.0), "Pipelined burst was not fully processed"
+    await a.close()
+
 async def test_slow_reader_does_not_block(ctx: TestContext):
     # One client will not read for a while. Another will flood. Server must not hang.
     slow = await ctx.new_client("SLOW")
@@ -556,32 +767,171 @@ async def test_abrupt_disconnect_no_global_hang(ctx: TestContext):
     assert await a.expect_command("PONG", timeout=1.0), "Server should remain responsive after peer abort"
     await a.close()
 
+async def test_stalled_reader_excess_sendq(ctx: TestContext):
+    # A member that never reads must be dropped once its SendQ overflows,
+    # and its channel peers must see the QUIT.
+    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4096)
+    sock.connect((ctx.host, ctx.port))
+    stalled = IRCClient("STALL", ctx.host, ctx.port, ctx.password, ctx.verbose)
+    stalled.reader, stalled.writer = await asyncio.open_connection(sock=sock)
+    stalled.connected = True
+    ctx.clients["STALL"] = stalled
+    flood = await ctx.new_client("FLOOD")
+    watch = await ctx.new_client("WATCH")
+    await register_minimal(stalled, "stalled")
+    await register_minimal(flood, "flooder")
+    await register_minimal(watch, "watcher")
+    for cl in (stalled, flood, watch):
+        cl.send("JOIN", "#sendq")
+        await cl.drain()
+        assert await cl.expect_numeric("366", timeout=2.0), "JOIN failed"
+
+    text = "x" * 400
+    dropped = False
+    for batch in range(400):  # up to ~16 MiB towards the stalled client
+        for i in range(100):
+            flood.send("PRIVMSG", "#sendq", trailing=f"{batch}.{i} {text}")
+        await flood.drain()
+        while True:
+            line = await watch.recv_line(timeout=0.05)
+            if line is None:
+                break
+            if " QUIT " in line and "Excess SendQ" in line:
+                dropped = True
+        if dropped:
+            break
+    assert dropped, "stalled reader was never dropped (no QUIT :Excess SendQ)"
+
+    # the stalled socket must now be closed by the server
+    closed = False
+    deadline = asyncio.get_event_loop().time() + 5.0
+    while asyncio.get_event_loop().time() < deadline:
+        try:
+            data = await asyncio.wait_for(stalled.reader.read(1 << 20), timeout=1.0)
+        except asyncio.TimeoutError:
+            continue
+        except ConnectionError:
+            closed = True
+            break
+        if not data:
+            closed = True
+            break
+    assert closed, "server kept the stalled connection open"
+    await drain_until_silent(watch)
+
+# === Idle cost: idle sockets must not wake the event loop ===
+def find_server_pid(port: int) -> Optional[int]:
+    """Linux only: map the LISTEN socket on `port` to the owning pid via /proc."""
+    import os
+    inode = None
+    for table in ("/proc/net/tcp", "/proc/net/tcp6"):
+        try:
+            with open(table) as f:
+                next(f)
+                for row in f:
+                    cols = row.split()
+                    if int(cols[1].split(":")[1], 16) == port and cols[3] == "0A":
+                        inode = cols[9]
+                        break
+        except OSError:
+            continue
+        if inode:
+            break
+    if not inode:
+        return None
+    target = f"socket:[{inode}]"
+    for pid in filter(str.isdigit, os.listdir("/proc")):
+        try:
+            for fd in os.listdir(f"/proc/{pid}/fd"):
+                if os.readlink(f"/proc/{pid}/fd/{fd}") == target:
+                    return int(pid)
+        except OSError:
+            continue
+    return None
+
+def process_load(pid: int) -> Tuple[float, int]:
+    """(cpu seconds, voluntary context switches) of a process."""
+    import os
+    with open(f"/proc/{pid}/stat") as f:
+        fields = f.read().rsplit(")", 1)[1].split()
+    cpu = (int(fields[11]) + int(fields[12])) / os.sysconf(os.sysconf_names["SC_CLK_TCK"])
+    switches = 0
+    with open(f"/proc/{pid}/status") as f:
+        for line in f:
+            if line.startswith("voluntary_ctxt_switches"):
+                switches = int(line.split()[1])
+    return cpu, switches
+
+IDLE_CLIENTS = 1000
+IDLE_WINDOW = 2.0
+
+async def test_idle_clients_no_spin(ctx: TestContext):
+    pid = find_server_pid(ctx.port)
+    if pid is None:
+        print(c("  (skipped: server pid not found via /proc)", "YELLOW"))
+        return
+    idle = []
+    try:
+        for i in range(IDLE_CLIENTS):
+            idle.append(await asyncio.open_connection(ctx.host, ctx.port))
+    except OSError as e:
+        for _, w in idle:
+            w.close()
+        print(c(f"  (skipped: could only open {len(idle)} sockets: {e})", "YELLOW"))
+        return
+    reg = await ctx.new_client("IDLE")
+    await register_minimal(reg, "idler")
+    await drain_until_silent(reg)
+
+    cpu0, sw0 = process_load(pid)
+    await asyncio.sleep(IDLE_WINDOW)
+    cpu1, sw1 = process_load(pid)
+    for _, w in idle:
+        w.close()
+
+    wakeups = (sw1 - sw0) / IDLE_WINDOW
+    cpu = (cpu1 - cpu0) / IDLE_WINDOW
+    assert cpu < 0.05, f"server used {cpu * 100:.0f}% CPU with {IDLE_CLIENTS} idle clients"
+    assert wakeups <= 5, f"event loop woke up {wakeups:.0f} times/s with {IDLE_CLIENTS} idle clients"
+
 # --------------------------- Test Suite ------------------------------------
 ALL_TESTS: List[TestCase] = [
     # Registration & basic numerics
     TestCase("Registration: basic errors", test_registration_basic_errors),
     TestCase("Registration: success & already registered", test_successful_registration),
+    TestCase("Registration: slower than --idle-timeout", test_slow_registration_idle_timeout),
     TestCase("Nick collision (433)", test_double_nick_collision),
+    TestCase("Nick casemapping (RFC 1459)", test_nick_casemapping),
 
     # Channels & messaging
     TestCase("JOIN + NAMES (353/366/331/324)", test_join_and_names),
+    TestCase("Channel casemapping (RFC 1459)", test_channel_casemapping),
     TestCase("PRIVMSG/NOTICE + common errors (401/404/411/412)", test_privmsg_channel_and_user),
 
     # Modes & permissions
-    TestCase("Modes: +o/+t topic protection", test_modes_topic_protection),
+    TestCase("Modes: +o/+v/+t topic protection", test_modes_topic_protection),
     TestCase("Modes: unknown flag & param errors (472/461/442)", test_modes_unknown_and_errors),
     TestCase("Modes: +k/+l/+i with JOIN/INVITE/KICK (475/471/473/482)", test_key_limit_invite),
 
     # PART/QUIT visibility
     TestCase("PART + QUIT visibility to peers", test_part_quit_visibility),
+    TestCase("JOIN 0 parts all channels", test_join_zero_parts_all),
 
     # WHOIS + PING
     TestCase("WHOIS + PING/PONG", test_whois_ping),
+    TestCase("STATS needs OPER", test_stats_needs_oper),
+    TestCase("Metrics socket (--metrics)", test_metrics_socket),
 
     # Robustness
     TestCase("Robustness: partial command assembly", test_partial_command_assembly),
+    TestCase("Robustness: 512-byte line limit (417) + pipelined burst", test_line_limit_and_pipelining),
     TestCase("Robustness: slow reader doesn't block others", test_slow_reader_does_not_block),
     TestCase("Robustness: abrupt disconnect doesn't hang server", test_abrupt_disconnect_no_global_hang),
+    TestCase("SendQ: stalled reader dropped with Excess SendQ", test_stalled_reader_excess_sendq),
+
+    # Idle cost
+    TestCase("Idle: 1000 idle clients don't spin the event loop", test_idle_clients_no_spin),
 ]
 
 # --------------------------- Runner ----------------------------------------
@@ -635,6 +985,8 @@ def parse_args():
     p.add_argument("--port", type=int, default=6667)
     p.add_argument("--password", default=None, help="PASS password if required")
     p.add_argument("--verbose", action="store_true")
+    p.add_argument("--metrics", default=None, help="the server's --metrics socket path, enables the exporter test")
+    p.add_argument("--idle-timeout", type=int, default=0, help="the server's --idle-timeout in seconds, enables the slow registration test")
     p.add_argument("--only", nargs="*", help="Run only the tests with exact names")
     p.add_argument("--print-manual-checklist", action="store_true", help="Print the manual evaluator checklist and exit")
     return p.parse_args()
@@ -644,7 +996,8 @@ async def amain():
     if args.print_manual_checklist:
         print(MANUAL_CHECKLIST)
         return
-    ctx = TestContext(host=args.host, port=args.port, password=args.password, verbose=args.verbose)
+    ctx = TestContext(host=args.host, port=args.port, password=args.password, verbose=args.verbose, metrics=args.metrics,
+                      idle_timeout=args.idle_timeout)
     failed, results = await run_tests(ctx, selected=args.only)
 
     # Summary
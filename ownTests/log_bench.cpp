@@ -0,0 +1,76 @@
+// Logging benchmark: PRIVMSG throughput through commandParser() with command
+// logging off, with cmd=debug through the async logger, and with the
+// "std::cout << line << std::endl" per command the server used to do.
+// Build & run: make bench && ./log_bench [messages] [log file]
+// stdout is pointed at the log file (default /dev/null) while measuring;
+// results go to stderr.
+#include "../include/Server.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+// mesaj başına ns; legacy: eski processInput + commandParser'ın iki cout satırı
+static double run(Server &server, Client &from, Client &to, long messages, bool legacy)
+{
+    const std::string text = "PRIVMSG #bench :hello there, this is a benchmark line";
+    double t0 = now();
+    for (long i = 0; i < messages; ++i)
+    {
+        if (legacy)
+        {
+            std::cout << "Processing complete command from client " << from.getFd() << ": ";
+            std::cout.write(text.data(), text.size()) << std::endl;
+            std::cout << "Processing command from client " << from.getFd() << ": ";
+            std::cout.write(text.data(), text.size()) << std::endl;
+        }
+        line(server, from, text);
+        if ((i & 63) == 63)
+            to.outbuf.clear();
+    }
+    double elapsed = now() - t0;
+    to.outbuf.clear();
+    return elapsed / messages * 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    long messages = argc > 1 ? std::atol(argv[1]) : 500000;
+    const char *path = argc > 2 ? argv[2] : "/dev/null";
+
+    int sink = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (sink < 0)
+    {
+        std::perror(path);
+        return 1;
+    }
+    dup2(sink, 1);
+    close(sink);
+
+    Server server;
+    Client *owner = server.addClient(FD_BASE);
+    Client *guest = server.addClient(FD_BASE + 1);
+    registerAs(server, *owner, "owner");
+    registerAs(server, *guest, "guest");
+    line(server, *owner, "JOIN #bench");
+    line(server, *guest, "JOIN #bench");
+    owner->outbuf.clear();
+    guest->outbuf.clear();
+
+    run(server, *owner, *guest, messages / 10, false); // ısınma
+    double off = run(server, *owner, *guest, messages, false);
+    double legacy = run(server, *owner, *guest, messages, true);
+
+    Log::configure("cmd=debug");
+    Log::start();
+    double async = run(server, *owner, *guest, messages, false);
+    Log::stop();
+    LogStats stats = Log::stats();
+
+    std::fprintf(stderr, "%ld messages, log to %s\n", messages, path);
+    std::fprintf(stderr, "%-22s %10s %12s\n", "", "ns/msg", "msgs/s");
+    std::fprintf(stderr, "%-22s %10.1f %12.0f\n", "logging off", off, 1e9 / off);
+    std::fprintf(stderr, "%-22s %10.1f %12.0f\n", "cmd=debug, async", async, 1e9 / async);
+    std::fprintf(stderr, "%-22s %10.1f %12.0f\n", "cout + endl (old)", legacy, 1e9 / legacy);
+    std::fprintf(stderr, "async: %lu logged, %lu written, %lu dropped\n", stats.logged, stats.written, stats.dropped);
+    return 0;
+}
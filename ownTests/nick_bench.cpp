@@ -0,0 +1,78 @@
+// Nick lookup microbenchmark: PRIVMSG-to-user cost vs. connected users.
+// Build & run: make bench && ./nick_bench [iterations]
+// "scan" is the by-value getNick() loop the handlers used before the nick index;
+// "privmsg" is the whole handlePrivMsg() path to a random user.
+#include "../include/Server.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+static Client *legacyScan(std::vector<Client *> &clients, const std::string &nick)
+{
+    for (std::vector<Client *>::iterator it = clients.begin(); it != clients.end(); ++it)
+    {
+        if ((*it)->getNick() == nick)
+            return *it;
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 200000;
+    const int sizes[] = { 100, 10000, 100000 };
+    volatile size_t sink = 0;
+
+    std::printf("%-8s %14s %12s %12s\n", "users", "scan ns", "index ns", "privmsg ns");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        int users = sizes[s];
+        // ~Server sahte fd'leri kapatırdı; süreç sonunda bırakılır
+        Server *server = new Server();
+        std::vector<Client *> clients;
+        std::vector<std::string> nicks;
+        for (int i = 0; i < users; ++i)
+        {
+            Client *cl = server->addClient(FD_BASE + i);
+            std::vector<std::string> params(1, "User" + to_string(i));
+            server->handleNick(params, *cl);
+            clients.push_back(cl);
+            nicks.push_back(params[0]);
+        }
+        Client *sender = clients[0];
+        sender->setUname("bench");
+        sender->setHname("localhost");
+
+        std::vector<size_t> order(1024);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = std::rand() % users;
+
+        // tarama O(n): tekrar sayısı kullanıcı sayısıyla azaltılır
+        long scans = std::max(100L, iterations * 100 / users);
+        double t0 = now();
+        for (long i = 0; i < scans; ++i)
+            sink += legacyScan(clients, nicks[order[i & 1023]]) != NULL;
+        double scan = (now() - t0) / scans * 1e9;
+
+        t0 = now();
+        for (long i = 0; i < iterations; ++i)
+            sink += server->findNick(nicks[order[i & 1023]]) != NULL;
+        double index = (now() - t0) / iterations * 1e9;
+
+        std::vector<std::string> params(2);
+        params[1] = "hello there";
+        t0 = now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            Client *target = clients[order[i & 1023]];
+            params[0] = nicks[order[i & 1023]];
+            server->handlePrivMsg(params, *sender);
+            sink += target->outbuf.size();
+            target->outbuf.clear();
+        }
+        double privmsg = (now() - t0) / iterations * 1e9;
+
+        std::printf("%-8d %14.1f %12.1f %12.1f\n", users, scan, index, privmsg);
+    }
+    return sink == 0;
+}
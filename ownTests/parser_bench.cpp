@@ -0,0 +1,87 @@
+// Parser microbenchmark: ns/message for typical client lines.
+// Build & run: make bench && ./parser_bench [iterations]
+// "legacy" is the substr/stringstream parser the server used before IrcMessage.
+#include "../include/IrcMessage.hpp"
+#include "bench_util.hpp"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+static std::vector<std::string> split(const std::string& s, char delim) {
+    std::vector<std::string> elems;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, delim)) {
+        elems.push_back(item);
+    }
+    return elems;
+}
+
+static void legacyParse(const std::string& line, std::string& cmd, std::vector<std::string>& params, std::string& trailing)
+{
+    std::string s = line;
+    size_t end = s.find_last_not_of(" \t\r\n");
+    if (end != std::string::npos) {
+        s = s.substr(0, end + 1);
+    } else {
+        s.clear();
+    }
+    if (!s.empty() && s[0]==':') {
+        size_t sp = s.find(' ');
+        s = (sp==std::string::npos) ? "" : s.substr(sp+1);
+    }
+    size_t colon = s.find(" :");
+    if (colon != std::string::npos) {
+        trailing = s.substr(colon+2);
+        s = s.substr(0, colon);
+    } else trailing.clear();
+    std::vector<std::string> p = split(s, ' ');
+    cmd = p.empty() ? "" : p[0];
+    for (size_t i=1;i<p.size();++i) if (!p[i].empty()) params.push_back(p[i]);
+}
+
+int main(int argc, char **argv)
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 2000000;
+    const char *lines[] = {
+        "PRIVMSG #general :hello everyone, how is it going today?",
+        "JOIN #general,#random key1,key2",
+        "PING :irc.example.net",
+        ":nick!user@host PRIVMSG #chan :prefixed message",
+        "@time=2024-01-01T00:00:00.000Z;msgid=abc PRIVMSG #c :tagged",
+    };
+    const char *names[] = { "PRIVMSG", "JOIN", "PING", "prefixed", "tagged" };
+    size_t count = sizeof(lines) / sizeof(lines[0]);
+    volatile size_t sink = 0;
+
+    std::printf("%-10s %12s %12s\n", "line", "legacy ns", "spans ns");
+    for (size_t l = 0; l < count; ++l)
+    {
+        std::string line = lines[l];
+
+        double t0 = now();
+        for (long i = 0; i < iterations / 10; ++i)
+        {
+            std::string cmd, trailing;
+            std::vector<std::string> params;
+            legacyParse(line, cmd, params, trailing);
+            sink += params.size() + cmd.size();
+        }
+        double legacy = (now() - t0) / (iterations / 10) * 1e9;
+
+        t0 = now();
+        for (long i = 0; i < iterations; ++i)
+        {
+            IrcMessage msg;
+            parseMessage(line.data(), line.size(), msg);
+            sink += msg.paramCount + msg.command.len;
+        }
+        double spans = (now() - t0) / iterations * 1e9;
+
+        std::printf("%-10s %12.1f %12.1f\n", names[l], legacy, spans);
+    }
+    return sink == 0;
+}
@@ -0,0 +1,90 @@
+// Client/Channel lifetime microbenchmark: ObjectPool vs. new/delete.
+// Build & run: make bench && ./pool_bench [cycles]
+// A working set of live clients and channels is churned in random order, as a
+// reconnect storm does; each cycle frees one client+channel and makes another.
+#include "../include/ObjectPool.hpp"
+#include "../include/Channel.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+#define LIVE 10000
+
+// yeni nesneye gerçek bir bağlantının ilk yazdıklarını yaz
+static void touch(Client *cl, Channel *ch, long i)
+{
+    cl->setNick("storm");
+    cl->setUname("user");
+    ch->addClient(cl);
+    (void)i;
+}
+
+int main(int argc, char **argv)
+{
+    long cycles = argc > 1 ? std::atol(argv[1]) : 1000000;
+    std::vector<size_t> order(cycles);
+    for (long i = 0; i < cycles; ++i)
+        order[i] = std::rand() % LIVE;
+    std::string name = "#storm";
+
+    std::vector<Client *> clients(LIVE);
+    std::vector<Channel *> channels(LIVE);
+
+    // new/delete
+    for (size_t i = 0; i < LIVE; ++i)
+    {
+        clients[i] = new Client(-1);
+        channels[i] = new Channel(name);
+        touch(clients[i], channels[i], i);
+    }
+    double t0 = now();
+    for (long i = 0; i < cycles; ++i)
+    {
+        size_t k = order[i];
+        delete channels[k];
+        delete clients[k];
+        clients[k] = new Client(-1);
+        channels[k] = new Channel(name);
+        touch(clients[k], channels[k], i);
+    }
+    double heap = (now() - t0) / cycles * 1e9;
+    for (size_t i = 0; i < LIVE; ++i)
+    {
+        delete channels[i];
+        delete clients[i];
+    }
+
+    // havuz
+    ObjectPool<Client> clientPool;
+    ObjectPool<Channel> channelPool;
+    for (size_t i = 0; i < LIVE; ++i)
+    {
+        clients[i] = clientPool.create(-1);
+        channels[i] = channelPool.create(name);
+        touch(clients[i], channels[i], i);
+    }
+    t0 = now();
+    for (long i = 0; i < cycles; ++i)
+    {
+        size_t k = order[i];
+        channelPool.destroy(channels[k]);
+        clientPool.destroy(clients[k]);
+        clients[k] = clientPool.create(-1);
+        channels[k] = channelPool.create(name);
+        touch(clients[k], channels[k], i);
+    }
+    double pooled = (now() - t0) / cycles * 1e9;
+    const PoolStats &st = clientPool.stats();
+    std::printf("%-12s %10s\n", "", "ns/cycle");
+    std::printf("%-12s %10.1f\n", "new/delete", heap);
+    std::printf("%-12s %10.1f\n", "pool", pooled);
+    std::printf("client pool: %lu slabs, %lu slots, %lu in use, peak %lu, %lu reused, %lu fresh\n",
+        (unsigned long)st.slabs, (unsigned long)st.capacity, (unsigned long)st.inUse,
+        (unsigned long)st.peak, st.reused, st.fresh);
+    for (size_t i = 0; i < LIVE; ++i)
+    {
+        channelPool.destroy(channels[i]);
+        clientPool.destroy(clients[i]);
+    }
+    return 0;
+}
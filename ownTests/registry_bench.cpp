@@ -0,0 +1,64 @@
+// Channel registry benchmark: cost of the channel lookup in PRIVMSG and in a
+// JOIN/PART pair with many channels, driven through commandParser().
+// Build & run: make bench && ./registry_bench [channels] [operations]
+// "owner" creates every channel and stays in all of them; "guest" joins and
+// parts random ones, so the channel set never changes during a measurement.
+#include "../include/Server.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv)
+{
+    size_t channels = argc > 1 ? std::atol(argv[1]) : 100000;
+    long operations = argc > 2 ? std::atol(argv[2]) : 200000;
+
+    std::streambuf *log = std::cout.rdbuf(NULL);
+    Server server;
+    Client *owner = server.addClient(FD_BASE);
+    Client *guest = server.addClient(FD_BASE + 1);
+    registerAs(server, *owner, "owner");
+    registerAs(server, *guest, "guest");
+
+    std::vector<std::string> names;
+    char name[32];
+    for (size_t i = 0; i < channels; ++i)
+    {
+        std::snprintf(name, sizeof(name), "#channel%lu", (unsigned long)i);
+        names.push_back(name);
+        line(server, *owner, "JOIN " + names.back());
+        owner->outbuf.clear();
+    }
+
+    std::vector<std::string> privmsg, join, part;
+    std::srand(7);
+    for (long i = 0; i < operations; ++i)
+    {
+        const std::string &target = names[std::rand() % channels];
+        privmsg.push_back("PRIVMSG " + target + " :hello");
+        join.push_back("JOIN " + target);
+        part.push_back("PART " + target);
+    }
+
+    double t0 = now();
+    for (long i = 0; i < operations; ++i)
+        line(server, *owner, privmsg[i]);
+    double tMsg = (now() - t0) / operations * 1e9;
+
+    t0 = now();
+    for (long i = 0; i < operations; ++i)
+    {
+        line(server, *guest, join[i]);
+        line(server, *guest, part[i]);
+        guest->outbuf.clear();
+        owner->outbuf.clear();
+    }
+    double tJoin = (now() - t0) / operations * 1e9;
+    std::cout.rdbuf(log);
+
+    std::printf("%lu channels\n", (unsigned long)channels);
+    std::printf("%-12s %10s\n", "", "ns/op");
+    std::printf("%-12s %10.1f\n", "PRIVMSG", tMsg);
+    std::printf("%-12s %10.1f\n", "JOIN+PART", tJoin);
+    return 0;
+}
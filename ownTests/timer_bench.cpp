@@ -0,0 +1,67 @@
+// Timer wheel microbenchmark: schedule/cancel cost and loop-side cost of
+// advance()+timeoutMs() with N connection timers, as in Server::runTimers().
+// Build & run: make bench && ./timer_bench [timers] [simulated seconds]
+// Every timer is a keepalive due 1..300 s ahead; when it fires it is
+// rescheduled like an active client's, so the wheel stays at N timers.
+#include "../include/TimerWheel.hpp"
+#include "bench_util.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static unsigned long long randomDelay()
+{
+    return 1000 + (unsigned long long)std::rand() % 299000;
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? std::atol(argv[1]) : 100000;
+    long seconds = argc > 2 ? std::atol(argv[2]) : 600;
+    std::vector<Timer> timers(count);
+    TimerWheel wheel;
+    unsigned long long clock = 1000000;
+    wheel.start(clock);
+
+    double t0 = now();
+    for (size_t i = 0; i < count; ++i)
+        wheel.schedule(timers[i], clock + randomDelay());
+    double schedule = (now() - t0) / count * 1e9;
+
+    // bağlantı başına bir kez ertele: okuma olmuş gibi
+    t0 = now();
+    for (size_t i = 0; i < count; ++i)
+        wheel.schedule(timers[i], clock + randomDelay());
+    double reschedule = (now() - t0) / count * 1e9;
+
+    // olay döngüsü: her 10 ms'de bir tur, süresi dolan yeniden kurulur
+    unsigned long long fired = 0;
+    volatile long long sink = 0;
+    t0 = now();
+    for (long step = 0; step < seconds * 100; ++step)
+    {
+        clock += 10;
+        wheel.advance(clock);
+        while (Timer *timer = wheel.nextExpired())
+        {
+            wheel.schedule(*timer, clock + randomDelay());
+            ++fired;
+        }
+        sink += wheel.timeoutMs(clock);
+    }
+    double loop = now() - t0;
+    double perTurn = loop / (seconds * 100) * 1e9;
+
+    t0 = now();
+    for (size_t i = 0; i < count; ++i)
+        wheel.cancel(timers[i]);
+    double cancel = (now() - t0) / count * 1e9;
+
+    std::printf("%lu timers, %ld simulated seconds, %llu fired\n", (unsigned long)count, seconds, fired);
+    std::printf("%-22s %10.1f ns\n", "schedule", schedule);
+    std::printf("%-22s %10.1f ns\n", "reschedule", reschedule);
+    std::printf("%-22s %10.1f ns\n", "cancel", cancel);
+    std::printf("%-22s %10.1f ns\n", "loop turn (10 ms)", perTurn);
+    std::printf("%-22s %10.1f ns\n", "per fired timer", fired ? loop / fired * 1e9 : 0.0);
+    return sink == -2;
+}
@@ -0,0 +1,112 @@
+#include "../include/BufferPool.hpp"
+#include <new>
+
+// boş buffer'ın ilk byte'ları listedeki bir sonrakini tutar
+struct FreeBuffer
+{
+	FreeBuffer *next;
+};
+
+struct SizeClass
+{
+	FreeBuffer *head;
+	size_t count;
+	size_t lowWater; // son trim()'den beri listenin en kısa hali; bu kadarı hiç kullanılmadı
+};
+
+static SizeClass classes[BUFFER_CLASS_COUNT];
+static BufferPoolStats counters;
+
+static size_t classIndex(size_t capacity)
+{
+	size_t index = 0;
+	while ((size_t)BUFFER_CLASS_MIN << index < capacity)
+		++index;
+	return index;
+}
+
+size_t BufferPool::classSize(size_t bytes)
+{
+	size_t size = BUFFER_CLASS_MIN;
+	while (size < bytes && size < BUFFER_CLASS_MAX)
+		size <<= 1;
+	return size;
+}
+
+char *BufferPool::acquire(size_t capacity)
+{
+	SizeClass &cls = classes[classIndex(capacity)];
+	char *buffer;
+	if (cls.head)
+	{
+		// LIFO: en son bırakılan hâlâ cache'te
+		buffer = reinterpret_cast<char *>(cls.head);
+		cls.head = cls.head->next;
+		if (--cls.count < cls.lowWater)
+			cls.lowWater = cls.count;
+		--counters.cached;
+		counters.cachedBytes -= capacity;
+		++counters.hits;
+	}
+	else
+	{
+		buffer = static_cast<char *>(::operator new(capacity));
+		++counters.misses;
+	}
+	++counters.borrowed;
+	counters.borrowedBytes += capacity;
+	if (counters.borrowedBytes > counters.peakBytes)
+		counters.peakBytes = counters.borrowedBytes;
+	return buffer;
+}
+
+void BufferPool::release(char *buffer, size_t capacity)
+{
+	if (!buffer)
+		return;
+	SizeClass &cls = classes[classIndex(capacity)];
+	FreeBuffer *node = reinterpret_cast<FreeBuffer *>(buffer);
+	node->next = cls.head;
+	cls.head = node;
+	++cls.count;
+	--counters.borrowed;
+	counters.borrowedBytes -= capacity;
+	++counters.cached;
+	counters.cachedBytes += capacity;
+}
+
+// bir aralık boyunca hiç ihtiyaç duyulmayan (lowWater kadar) buffer serbest bırakılır.
+// Bunlar LIFO listenin dibindekilerdir; baştaki sıcak buffer'lar bir sonraki patlamaya kalır
+void BufferPool::trim()
+{
+	for (size_t i = 0; i < BUFFER_CLASS_COUNT; ++i)
+	{
+		SizeClass &cls = classes[i];
+		size_t capacity = (size_t)BUFFER_CLASS_MIN << i;
+		FreeBuffer **cut = &cls.head;
+		for (size_t kept = cls.count - cls.lowWater; kept > 0; --kept)
+			cut = &(*cut)->next;
+		FreeBuffer *node = *cut;
+		*cut = NULL;
+		while (node)
+		{
+			FreeBuffer *next = node->next;
+			::operator delete(node);
+			node = next;
+			--cls.count;
+			--counters.cached;
+			counters.cachedBytes -= capacity;
+			++counters.trimmed;
+		}
+		cls.lowWater = cls.count;
+	}
+}
+
+void BufferPool::releaseAll()
+{
+	for (size_t i = 0; i < BUFFER_CLASS_COUNT; ++i)
+		classes[i].lowWater = classes[i].count;
+	trim();
+}
+
+const BufferPoolStats &BufferPool::stats() { return counters; }
@@ -1,5 +1,6 @@
 #include "../include/Channel.hpp"
 #include "../include/libs.hpp"
+#include "../include/CaseMap.hpp"
 
 Channel::Channel(const std::string& channelName) 
     : name(channelName), topic(""), pin(""), invite_only(false), topic_restricted(true), user_limit(0)
@@ -8,6 +9,8 @@ Channel::Channel(const std::string& channelName)
 
 Channel::~Channel()
 {
+    for (std::vector<Member>::iterator it = members.begin(); it != members.end(); ++it)
+        it->client->partChannel(this);
 }
 
 bool Channel::addClient(Client* client, const std::string& providedKey)
@@ -26,46 +29,38 @@ bool Channel::addClient(Client* client, const std::string& providedKey)
         return false;
     
     // Kullanıcıyı ekle
-    members.push_back(client);
-    
-    if (members.size() == 1)
-        operators.push_back(client);
+    // ilk giren operatör olur
+    Member member = { client, members.empty() ? (unsigned)MEMBER_OP : 0 };
+    memberIndex[client] = members.size();
+    members.push_back(member);
+    client->joinChannel(this);
     
     return true;
 }
 
 void Channel::removeClient(Client* client)
 {
-    for (std::vector<Client*>::iterator it = members.begin(); it != members.end(); ++it)
+    std::tr1::unordered_map<Client*, size_t>::iterator it = memberIndex.find(client);
+    if (it == memberIndex.end())
+        return;
+    client->partChannel(this);
+    // son üye boşalan yere taşınır
+    size_t index = it->second;
+    memberIndex.erase(it);
+    if (index != members.size() - 1)
     {
-        if (*it == client)
-        {
-            members.erase(it);
-            break;
-        }
-    }
-    
-    for (std::vector<Client*>::iterator it = operators.begin(); it != operators.end(); ++it)
-    {
-        if (*it == client)
-        {
-            operators.erase(it);
-            break;
-        }
+        members[index] = members.back();
+        memberIndex[members[index].client] = index;
     }
+    members.pop_back();
 }
 
 bool Channel::hasClient(Client* client)
 {
-    for (std::vector<Client*>::iterator it = members.begin(); it != members.end(); ++it)
-    {
-        if (*it == client)
-            return true;
-    }
-    return false;
+    return memberIndex.count(client) != 0;
 }
 
-std::string Channel::getName() const
+const std::string& Channel::getName() const
 {
     return name;
 }
@@ -95,37 +90,59 @@ void Channel::setKey(const std::string& newKey)
     pin = newKey;
 }
 
-std::vector<Client*> Channel::getMembers() const
+const std::vector<Member>& Channel::getMembers() const
 {
     return members;
 }
 
-bool Channel::isOperator(Client* client)
+// üye değilse 0
+unsigned Channel::getFlags(Client* client) const
+{
+    std::tr1::unordered_map<Client*, size_t>::const_iterator it = memberIndex.find(client);
+    return it == memberIndex.end() ? 0 : members[it->second].flags;
+}
+
+void Channel::setFlag(Client* client, unsigned flag, bool on)
+{
+    std::tr1::unordered_map<Client*, size_t>::iterator it = memberIndex.find(client);
+    if (it == memberIndex.end())
+        return;
+    if (on)
+        members[it->second].flags |= flag;
+    else
+        members[it->second].flags &= ~flag;
+}
+
+// 353 için "@op +voice user" listesi, üye başına tek geçiş
+std::string Channel::namesList() const
 {
-    for (std::vector<Client*>::iterator it = operators.begin(); it != operators.end(); ++it)
+    std::string list;
+    for (std::vector<Member>::const_iterator it = members.begin(); it != members.end(); ++it)
     {
-        if (*it == client)
-            return true;
+        if (!list.empty())
+            list += ' ';
+        if (it->flags & MEMBER_OP)
+            list += '@';
+        else if (it->flags & MEMBER_VOICE)
+            list += '+';
+        list += it->client->getNick();
     }
-    return false;
+    return list;
+}
+
+bool Channel::isOperator(Client* client)
+{
+    return (getFlags(client) & MEMBER_OP) != 0;
 }
 
 void Channel::addOperator(Client* client)
 {
-    if (!isOperator(client))
-        operators.push_back(client);
+    setFlag(client, MEMBER_OP, true);
 }
 
 void Channel::removeOperator(Client* client)
 {
-    for (std::vector<Client*>::iterator it = operators.begin(); it != operators.end(); ++it)
-    {
-        if (*it == client)
-        {
-            operators.erase(it);
-            break;
-        }
-    }
+    setFlag(client, MEMBER_OP, false);
 }
 
 size_t Channel::getMemberCount() const
@@ -135,11 +152,19 @@ size_t Channel::getMemberCount() const
 
 void Channel::sendMsg(const std::string& message, Client* sender)
 {
-    for (std::vector<Client*>::iterator it = members.begin(); it != members.end(); ++it)//kanaldaki herkese mesajı gönderiyor
+    // satır bir kez kopyalanır, her üyenin kuyruğu aynı bloğu referansla tutar
+    SharedMessage *shared = SharedMessage::create(message);
+    sendMsg(shared, sender);
+    shared->release();
+}
+
+void Channel::sendMsg(SharedMessage* message, Client* sender)
+{
+    for (std::vector<Member>::iterator it = members.begin(); it != members.end(); ++it)//kanaldaki herkese mesajı gönderiyor
     {
-        if (*it != sender)
+        if (it->client != sender)
         {
-            (*it)->outbuf += message;//her bir üyenin output bufferına gönderiyor
+            it->client->queue(message);
         }
     }
 }
@@ -174,13 +199,17 @@ void Channel::setUserLimit(int limit)
     user_limit = limit;
 }
 
+// nick'ler RFC 1459 casemapping ile karşılaştırılır, NICK/INVITE aramasıyla aynı
 void Channel::inviteUser(const std::string& nick)
 {
-    if (std::find(invitedNicks.begin(), invitedNicks.end(), nick) == invitedNicks.end())
+    if (!isInvited(nick))
         invitedNicks.push_back(nick);
 }
 
 bool Channel::isInvited(const std::string& nick) const
 {
-    return std::find(invitedNicks.begin(), invitedNicks.end(), nick) != invitedNicks.end();
+    for (size_t i = 0; i < invitedNicks.size(); ++i)
+        if (ircEquals(invitedNicks[i], nick))
+            return true;
+    return false;
 }
\ No newline at end of file
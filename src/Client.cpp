@@ -1,28 +1,48 @@
 #include "../include/Client.hpp"
 
+static unsigned long long queued = 0; // STATS m'nin komut başına çıkış byte'ları buradan
+static unsigned long long queuedLines = 0; // aynısı satır olarak, metrics için
+
 Client::Client() 
 {
 	this->fd = 0;
+	this->profile = new ClientProfile();
+	this->lastInput = 0;
+	this->lastActivity = 0;
 	this->is_authenticated = false;
 	this->is_registered = false;
 	this->nick = "";
-	this->username = "";
 	this->away = false;
-	this->awayMessage = "";
+	this->oper = false;
+	this->is_pending = false;
+	this->write_armed = false;
+	this->pendingList = NULL;
+	this->sendqClasses = NULL;
+	this->sendq_excess = SendQClass::NONE;
 }
 
 Client::Client(int _fd)
 {
 	this->fd = _fd;
+	this->profile = new ClientProfile();
+	this->lastInput = 0;
+	this->lastActivity = 0;
 	this->is_authenticated = false;
 	this->is_registered = false;
 	this->nick = "";
-	this->username = "";
 	this->away = false;
-	this->awayMessage = "";
+	this->oper = false;
+	this->is_pending = false;
+	this->write_armed = false;
+	this->pendingList = NULL;
+	this->sendqClasses = NULL;
+	this->sendq_excess = SendQClass::NONE;
 }
 
-Client::~Client() {}
+Client::~Client()
+{
+	delete this->profile;
+}
 
 int Client::getFd()
 {
@@ -44,21 +64,115 @@ void Client::setAuth(bool i) {this->is_authenticated = i;}
 bool Client::getRegis() { return this->is_registered; }
 void Client::setRegis(bool i) {this->is_registered = i;}
 
-std::string Client::getNick(void){return this->nick;}
-std::string Client::getUname(void){return this->username;}
-std::string Client::getRname(void){return this->realname;}
-std::string Client::getHname(void){return this->hostname;}
+const std::string &Client::getNick(void) const {return this->nick;}
+const std::string &Client::getUname(void) const {return this->profile->username;}
+const std::string &Client::getRname(void) const {return this->profile->realname;}
+const std::string &Client::getHname(void) const {return this->profile->hostname;}
+struct sockaddr_in &Client::getAddr(void) {return this->profile->in_soc;}
+Timer &Client::getTimer(void) {return this->profile->keepalive;}
+unsigned long long Client::getLastInput(void) const {return this->lastInput;}
+void Client::setLastInput(unsigned long long ms) {this->lastInput = ms;}
+unsigned long long Client::getPingSent(void) const {return this->profile->pingSent;}
+void Client::setPingSent(unsigned long long ms) {this->profile->pingSent = ms;}
+unsigned long long Client::getLastActivity(void) const {return this->lastActivity;}
+void Client::setLastActivity(unsigned long long ms) {this->lastActivity = ms;}
+time_t Client::getSignon(void) const {return this->profile->signon;}
+void Client::setSignon(time_t when) {this->profile->signon = when;}
+
+// prefix yalnızca nick/user/host değişince yeniden kurulur; kayıttan sonra sadece NICK değiştirir
+const std::string &Client::getPrefix(void) const
+{
+	if (this->prefix.empty())
+	{
+		const ClientProfile &p = *this->profile;
+		this->prefix.reserve(this->nick.size() + p.username.size() + p.hostname.size() + 3);
+		this->prefix.append(1, ':').append(this->nick).append(1, '!').append(p.username).append(1, '@').append(p.hostname);
+	}
+	return this->prefix;
+}
 
-void Client::setNick(std::string nick){this->nick = nick;}
-void Client::setUname(std::string username){this->username = username;}
-void Client::setHname(std::string hostname){this->hostname = hostname;}
-void Client::setRname(std::string realname){this->realname = realname;}
+void Client::setNick(std::string nick){this->nick = nick; this->prefix.clear();}
+void Client::setUname(std::string username){this->profile->username = username; this->prefix.clear();}
+void Client::setHname(std::string hostname){this->profile->hostname = hostname; this->prefix.clear();}
+void Client::setRname(std::string realname){this->profile->realname = realname;}
 
 bool Client::isAway() { return this->away; }
 void Client::setAway(bool status) { this->away = status; }
-std::string Client::getAwayMessage() { return this->awayMessage; }
-void Client::setAwayMessage(std::string message) { this->awayMessage = message; }
+bool Client::isOper() const { return this->oper; }
+void Client::setOper(bool status) { this->oper = status; }
+const std::string &Client::getAwayMessage() const { return this->profile->awayMessage; }
+void Client::setAwayMessage(std::string message) { this->profile->awayMessage = message; }
+
+const std::set<Channel *> &Client::getChannels() const { return this->profile->channels; }
+bool Client::inChannel(Channel *channel) const { return this->profile->channels.count(channel) != 0; }
+void Client::joinChannel(Channel *channel) { this->profile->channels.insert(channel); }
+void Client::partChannel(Channel *channel) { this->profile->channels.erase(channel); }
+
+void Client::setPendingList(std::vector<int> *list) { this->pendingList = list; }
+bool Client::isWriteArmed() { return this->write_armed; }
+void Client::setWriteArmed(bool armed) { this->write_armed = armed; }
+void Client::clearPending() { this->is_pending = false; }
+
+void Client::setSendQClasses(const SendQClass *classes) { this->sendqClasses = classes; }
+int Client::getSendQClass() { return this->is_registered ? SendQClass::USER : SendQClass::UNREGISTERED; }
+int Client::getSendQExcess() { return this->sendq_excess; }
+void Client::resetSendQ() { this->sendq_excess = SendQClass::NONE; }
+
+void Client::queue(const std::string &line)
+{
+	if (this->sendq_excess)
+		return;
+	this->outbuf.push(line);
+	queued += line.size();
+	++queuedLines;
+	checkSendQ();
+	markPending();
+}
+
+void Client::queue(SharedMessage *msg)
+{
+	if (this->sendq_excess)
+		return;
+	this->outbuf.push(msg);
+	queued += msg->size();
+	queuedLines += msg->lineCount();
+	checkSendQ();
+	markPending();
+}
 
+size_t Client::bufferedBytes() const { return this->inbuf.size() + this->outbuf.size(); }
+unsigned long long Client::queuedBytes() { return queued; }
+unsigned long long Client::queuedMessages() { return queuedLines; }
 
+void Client::queueTail(size_t bytes)
+{
+	this->outbuf.grewTail(bytes);
+	queued += bytes;
+	++queuedLines;
+	checkSendQ();
+	markPending();
+}
 
+// limit aşılırsa kuyruk atılır; bağlantıyı flushPending kapatır (kanal döngüsünün ortasındayız)
+void Client::checkSendQ()
+{
+	if (!this->sendqClasses)
+		return;
+	const SendQClass &cls = this->sendqClasses[getSendQClass()];
+	if (this->outbuf.size() > cls.maxBytes)
+		this->sendq_excess = SendQClass::BYTES;
+	else if (this->outbuf.messageCount() > cls.maxMessages)
+		this->sendq_excess = SendQClass::MESSAGES;
+	else
+		return;
+	this->outbuf.clear();
+}
 
+// outbuf boş değilse (ya da SendQ aşıldıysa) server'ın flush listesine bir kez eklenir
+void Client::markPending()
+{
+	if (this->is_pending || !this->pendingList || (this->outbuf.empty() && !this->sendq_excess))
+		return;
+	this->is_pending = true;
+	this->pendingList->push_back(this->fd);
+}
@@ -0,0 +1,50 @@
+#include "../include/Clock.hpp"
+
+#define CALIBRATION_NS 10000000ULL // cycleNs() en az bu kadarlık aralıktan hesaplanır
+
+static unsigned long long readNs(clockid_t id)
+{
+	struct timespec ts;
+	clock_gettime(id, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static unsigned long long readMs(clockid_t id)
+{
+	return readNs(id) / 1000000;
+}
+
+Clock::Clock() : monotonic(0), wall(0)
+{
+	this->cycleBase = cycles();
+	this->nsBase = readNs(CLOCK_MONOTONIC);
+}
+
+void Clock::update()
+{
+	this->monotonic = readMs(CLOCK_MONOTONIC);
+	this->wall = readMs(CLOCK_REALTIME);
+}
+
+unsigned long long Clock::monotonicMs() const { return this->monotonic; }
+unsigned long long Clock::wallMs() const { return this->wall; }
+time_t Clock::wallSeconds() const { return this->wall / 1000; }
+
+// açılıştan beri geçen süre üzerinden; açılıştan hemen sonra çağrılırsa kısa bir süre bekler
+double Clock::cycleNs() const
+{
+	unsigned long long ns;
+	while ((ns = readNs(CLOCK_MONOTONIC) - this->nsBase) < CALIBRATION_NS)
+		;
+	unsigned long long elapsed = cycles() - this->cycleBase;
+	return elapsed ? (double)ns / elapsed : 1.0;
+}
+
+std::string Clock::format(time_t when)
+{
+	struct tm parts;
+	char text[64];
+	gmtime_r(&when, &parts);
+	size_t len = strftime(text, sizeof(text), "%a %b %d %Y at %H:%M:%S UTC", &parts);
+	return std::string(text, len);
+}
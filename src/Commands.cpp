@@ -0,0 +1,85 @@
+#include "../include/Commands.hpp"
+#include "../include/Server.hpp"
+
+#define COMMAND_MAX_LEN 7 // PRIVMSG
+#define LETTERS 26
+
+// Kayıt öncesi izin verilenler: CAP, PASS, NICK, USER, PING, PONG, QUIT (HexChat için)
+static const CommandEntry commands[] = {
+	// name      handler                 registration  minParams  cost
+	{ "PRIVMSG", &Server::handlePrivMsg, true,  0, 1 }, // 411/412 handler'da
+	{ "NOTICE",  &Server::handleNotice,  true,  0, 1 }, // hatada sessiz kalır
+	{ "PING",    &Server::handlePing,    false, 0, 1 }, // 409 handler'da
+	{ "PONG",    &Server::handlePong,    false, 0, 0 },
+	{ "JOIN",    &Server::handleJoin,    true,  1, 2 },
+	{ "PART",    &Server::handlePart,    true,  1, 1 },
+	{ "MODE",    &Server::handleMode,    true,  1, 1 },
+	{ "TOPIC",   &Server::handleTopic,   true,  1, 1 },
+	{ "NAMES",   &Server::handleName,    true,  0, 2 },
+	{ "LIST",    &Server::handleList,    true,  0, 2 },
+	{ "INVITE",  &Server::handleInvite,  true,  2, 1 },
+	{ "KICK",    &Server::handleKick,    true,  2, 1 },
+	{ "WHO",     &Server::handleWho,     true,  0, 2 },
+	{ "WHOIS",   &Server::handleWhois,   true,  1, 2 },
+	{ "AWAY",    &Server::handleAway,    true,  0, 1 },
+	{ "BACK",    &Server::handleBack,    true,  0, 1 },
+	{ "MOTD",    &Server::handleMotd,    true,  0, 1 },
+	{ "CAP",     &Server::handleCap,     false, 1, 1 },
+	{ "PASS",    &Server::handlePass,    false, 1, 1 },
+	{ "NICK",    &Server::handleNick,    false, 0, 1 }, // 431 handler'da
+	{ "USER",    &Server::handleUser,    false, 4, 1 },
+	{ "QUIT",    &Server::handleQuit,    false, 0, 0 },
+	{ "OPER",    &Server::handleOper,    true,  2, 1 },
+	{ "STATS",   &Server::handleStats,   true,  1, 2 }, // 481 handler'da
+};
+
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+// (uzunluk, ilk harf) -> ilk aday + 1; aynı kovadaki diğerleri chain ile, 0 = yok
+static unsigned char buckets[COMMAND_MAX_LEN + 1][LETTERS];
+static unsigned char chain[COMMAND_COUNT];
+static bool indexed = false;
+
+static inline unsigned char upper(unsigned char c)
+{
+	return (c >= 'a' && c <= 'z') ? c - ('a' - 'A') : c;
+}
+
+// komutlar yalnızca core thread'de işlenir; ilk aramada bir kez kurulur
+static void buildIndex()
+{
+	// tersten: kovada tablodaki sıra (sık kullanılan önce) korunur
+	for (size_t i = COMMAND_COUNT; i-- > 0; )
+	{
+		const char *name = commands[i].name;
+		unsigned char &head = buckets[std::strlen(name)][name[0] - 'A'];
+		chain[i] = head;
+		head = i + 1;
+	}
+	indexed = true;
+}
+
+const CommandEntry *findCommand(const char *name, size_t len)
+{
+	if (len == 0 || len > COMMAND_MAX_LEN)
+		return NULL;
+	unsigned char first = upper(name[0]);
+	if (first < 'A' || first > 'Z')
+		return NULL;
+	if (!indexed)
+		buildIndex();
+	for (unsigned char i = buckets[len][first - 'A']; i; i = chain[i - 1])
+	{
+		const char *candidate = commands[i - 1].name;
+		size_t k = 1;
+		while (k < len && upper(name[k]) == (unsigned char)candidate[k])
+			++k;
+		if (k == len)
+			return &commands[i - 1];
+	}
+	return NULL;
+}
+
+size_t commandCount() { return COMMAND_COUNT; }
+const CommandEntry &commandAt(size_t index) { return commands[index]; }
+size_t commandIndex(const CommandEntry *entry) { return entry - commands; }
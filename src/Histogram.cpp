@@ -0,0 +1,48 @@
+#include "../include/Histogram.hpp"
+
+Histogram::Histogram()
+{
+	reset();
+}
+
+// bucket'taki en büyük değer; satır r >= 1, 2^(r + 3) ile başlayan ikinin kuvvetini böler
+unsigned long long Histogram::upperBound(size_t index)
+{
+	if (index < HISTOGRAM_SUB_COUNT)
+		return index;
+	int shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+	unsigned long long lower = (unsigned long long)(HISTOGRAM_SUB_COUNT + (index & (HISTOGRAM_SUB_COUNT - 1))) << shift;
+	return lower + (1ULL << shift) - 1;
+}
+
+unsigned long long Histogram::count() const { return this->total; }
+unsigned long long Histogram::max() const { return this->maxValue; }
+unsigned long long Histogram::sum() const { return this->sumValue; }
+
+unsigned long long Histogram::percentile(double fraction) const
+{
+	if (this->total == 0)
+		return 0;
+	// en az bu kadar değerin kendisinden küçük ya da eşit olduğu sıra (yukarı yuvarlanır)
+	double exact = fraction * this->total;
+	unsigned long long rank = (unsigned long long)exact;
+	if (rank < exact || rank < 1)
+		++rank;
+	unsigned long long seen = 0;
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		seen += this->counts[i];
+		if (seen >= rank)
+			return upperBound(i) < this->maxValue ? upperBound(i) : this->maxValue;
+	}
+	return this->maxValue;
+}
+
+void Histogram::reset()
+{
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		this->counts[i] = 0;
+	this->total = 0;
+	this->maxValue = 0;
+	this->sumValue = 0;
+}
@@ -0,0 +1,193 @@
+#include "../include/InputBuffer.hpp"
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <sys/uio.h>
+
+#define RING_MASK (this->capacity - 1)
+
+InputBuffer::InputBuffer()
+	: ring(NULL), capacity(0), want(INPUT_RING_MIN), head(0), count(0), scanned(0), discarding(false) {}
+
+InputBuffer::~InputBuffer()
+{
+	BufferPool::release(this->ring, this->capacity);
+}
+
+// en az bytes kadar yer: ring yoksa ödünç alınır, küçükse bir üst sınıfa taşınır
+void InputBuffer::reserve(size_t bytes)
+{
+	if (this->ring && this->capacity >= bytes)
+		return;
+	size_t size = BufferPool::classSize(std::max(bytes, this->want));
+	if (size <= this->capacity)
+		return;
+	char *bigger = BufferPool::acquire(size);
+	if (this->ring)
+	{
+		// bekleyen baytlar yeni ring'in başına düz kopyalanır
+		size_t first = std::min(this->count, this->capacity - this->head);
+		std::memcpy(bigger, this->ring + this->head, first);
+		std::memcpy(bigger + first, this->ring, this->count - first);
+		BufferPool::release(this->ring, this->capacity);
+		this->head = 0;
+	}
+	this->ring = bigger;
+	this->capacity = size;
+}
+
+// boş ring havuza döner; discarding durumu korunur
+void InputBuffer::release()
+{
+	if (this->count > 0 || !this->ring)
+		return;
+	BufferPool::release(this->ring, this->capacity);
+	this->ring = NULL;
+	this->capacity = 0;
+	this->head = 0;
+	this->scanned = 0;
+}
+
+size_t InputBuffer::size() const { return this->count; }
+size_t InputBuffer::space() const { return this->capacity - this->count; }
+size_t InputBuffer::reserved() const { return this->capacity; }
+
+void InputBuffer::clear()
+{
+	this->count = 0;
+	this->discarding = false;
+	release();
+}
+
+void InputBuffer::drop(size_t n)
+{
+	this->head = (this->head + n) & RING_MASK;
+	this->count -= n;
+	this->scanned = 0;
+	release();
+}
+
+ssize_t InputBuffer::readFrom(int fd)
+{
+	// dolu ring (yarım satır) bir üst sınıfa büyür
+	reserve(this->count + 1);
+	size_t tail = (this->head + this->count) & RING_MASK;
+	size_t free = space();
+	if (free == 0)
+	{
+		// INPUT_RING_SIZE'da nextLine() her çağrıda yer açar; buraya gelinmemeli
+		errno = ENOBUFS;
+		return -1;
+	}
+	struct iovec iov[2];
+	int segments = 1;
+	iov[0].iov_base = this->ring + tail;
+	iov[0].iov_len = free;
+	if (tail + free > this->capacity)
+	{
+		// boş alan ring sonunu aşıyor: iki parça tek readv ile doldurulur
+		iov[0].iov_len = this->capacity - tail;
+		iov[1].iov_base = this->ring;
+		iov[1].iov_len = free - iov[0].iov_len;
+		segments = 2;
+	}
+	ssize_t n = readv(fd, iov, segments);
+	if (n <= 0)
+	{
+		release();
+		return n;
+	}
+	this->count += n;
+	// ring'i dolduran okumalar bir sonraki ödünç için sınıfı büyütür, küçükler küçültür
+	if ((size_t)n == free)
+		this->want = std::min(this->capacity * 2, (size_t)INPUT_RING_SIZE);
+	else if ((size_t)n < this->capacity / 4 && this->want > INPUT_RING_MIN)
+		this->want /= 2;
+	return n;
+}
+
+size_t InputBuffer::append(const char *data, size_t len)
+{
+	if (len == 0)
+		return 0;
+	// gelen parçanın boyu belli: tek seferde yeterli sınıf alınır
+	reserve(std::min(this->count + len, (size_t)INPUT_RING_SIZE));
+	size_t take = std::min(len, space());
+	if (take == 0)
+		return 0;
+	size_t tail = (this->head + this->count) & RING_MASK;
+	size_t first = std::min(take, this->capacity - tail);
+	std::memcpy(this->ring + tail, data, first);
+	std::memcpy(this->ring, data + first, take - first);
+	this->count += take;
+	return take;
+}
+
+// head'den itibaren '\n'in uzaklığı; yoksa count. Taranan kısım tekrar taranmaz.
+size_t InputBuffer::findNewline()
+{
+	while (this->scanned < this->count)
+	{
+		size_t pos = (this->head + this->scanned) & RING_MASK;
+		size_t span = std::min(this->count - this->scanned, this->capacity - pos);
+		const char *hit = static_cast<const char *>(std::memchr(this->ring + pos, '\n', span));
+		if (hit)
+			return this->scanned + (hit - (this->ring + pos));
+		this->scanned += span;
+	}
+	return this->count;
+}
+
+int InputBuffer::nextLine(const char *&line, size_t &len)
+{
+	while (this->count > 0)
+	{
+		size_t nl = findNewline();
+		size_t limit = IRC_LINE_MAX;
+		if (this->ring[this->head] == '@')
+			limit += IRC_TAGS_MAX;
+		if (nl == this->count)
+		{
+			// satır sonu yok: limit aşıldıysa şimdiye kadar gelen atılır
+			if (this->count < limit && !this->discarding)
+				return NONE;
+			bool report = !this->discarding;
+			this->discarding = true;
+			drop(this->count);
+			return report ? TOO_LONG : NONE;
+		}
+		if (this->discarding)
+		{
+			// aşan satırın kalanı
+			this->discarding = false;
+			drop(nl + 1);
+			continue;
+		}
+		if (nl + 1 > limit)
+		{
+			drop(nl + 1);
+			return TOO_LONG;
+		}
+
+		len = nl;
+		if (len > 0 && this->ring[(this->head + len - 1) & RING_MASK] == '\r')
+			len--;
+		if (this->head + len <= this->capacity)
+			line = this->ring + this->head;
+		else
+		{
+			// ring sonunu aşan satır düzleştirilir
+			size_t first = this->capacity - this->head;
+			this->wrapped.assign(this->ring + this->head, first);
+			this->wrapped.append(this->ring, len - first);
+			line = this->wrapped.data();
+		}
+		// görünüm bir sonraki çağrıya kadar geçerli: boşalan ring'i hemen bırakma
+		this->head = (this->head + nl + 1) & RING_MASK;
+		this->count -= nl + 1;
+		this->scanned = 0;
+		return LINE;
+	}
+	release(); // önceki satırın görünümü artık kullanılmıyor
+	return NONE;
+}
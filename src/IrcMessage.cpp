@@ -0,0 +1,76 @@
+#include "../include/IrcMessage.hpp"
+#include <cstring>
+
+bool IrcSpan::equals(const char *s) const
+{
+	return std::strlen(s) == len && std::memcmp(data, s, len) == 0;
+}
+
+static void skipSpaces(const char *&p, const char *end)
+{
+	while (p < end && *p == ' ')
+		++p;
+}
+
+// bir sonraki boşluğa kadar olan kelime
+static IrcSpan word(const char *&p, const char *end)
+{
+	IrcSpan s;
+	s.data = p;
+	const char *sp = static_cast<const char *>(std::memchr(p, ' ', end - p));
+	p = sp ? sp : end;
+	s.len = p - s.data;
+	return s;
+}
+
+bool parseMessage(const char *line, size_t len, IrcMessage &msg)
+{
+	const char *p = line;
+	const char *end = line + len;
+	IrcSpan none = { line, 0 };
+
+	msg.tags = none;
+	msg.prefix = none;
+	msg.command = none;
+	msg.paramCount = 0;
+	msg.trailing = none;
+	msg.hasTrailing = false;
+
+	// sondaki boşluklar parametre sayılmaz
+	while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n'))
+		--end;
+	skipSpaces(p, end);
+	if (p < end && *p == '@')
+	{
+		++p;
+		msg.tags = word(p, end);
+		skipSpaces(p, end);
+	}
+	if (p < end && *p == ':')
+	{
+		++p;
+		msg.prefix = word(p, end);
+		skipSpaces(p, end);
+	}
+	if (p == end)
+		return false;
+	msg.command = word(p, end);
+
+	while (true)
+	{
+		skipSpaces(p, end);
+		if (p == end)
+			break;
+		if (*p == ':' || msg.paramCount == IrcMessage::MAX_PARAMS - 1)
+		{
+			if (*p == ':')
+				++p;
+			msg.trailing.data = p;
+			msg.trailing.len = end - p;
+			msg.hasTrailing = true;
+			break;
+		}
+		msg.params[msg.paramCount++] = word(p, end);
+	}
+	return true;
+}
@@ -0,0 +1,335 @@
+#include "../include/Log.hpp"
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <strings.h>
+#include <stdexcept>
+
+#define LOG_BATCH 65536 // writer'ın fd başına tampon boyutu
+
+struct LogSlot
+{
+	volatile unsigned long sequence; // == pozisyon: boş, == pozisyon + 1: dolu
+	unsigned long long time;
+	unsigned char level;
+	unsigned char subsystem;
+	unsigned short length;
+	char text[LOG_LINE_MAX];
+};
+
+struct LogBatch
+{
+	int fd;
+	size_t length;
+	char data[LOG_BATCH];
+};
+
+static const char *levelNames[] = { "DEBUG", "INFO", "WARN", "ERROR", "OFF" };
+static const char *subsystemNames[] = { "core", "net", "cmd" };
+
+unsigned char Log::thresholds[Log::SUBSYSTEM_COUNT] = { Log::INFO, Log::INFO, Log::INFO };
+
+static LogSlot ring[LOG_RING_SLOTS];
+static volatile unsigned long enqueuePos; // üreticiler CAS ile ilerletir
+static volatile unsigned long dequeuePos; // yalnızca writer yazar
+static volatile unsigned long long clockMs;
+static LogStats counters;
+static LogBatch out = { 1, 0, "" };
+static LogBatch err = { 2, 0, "" };
+
+static pthread_t writer;
+static volatile bool running;
+static volatile bool sleeping; // writer uyandırılmayı bekliyor
+static pthread_mutex_t wakeLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake = PTHREAD_COND_INITIALIZER;
+
+static void flush(LogBatch &batch)
+{
+	size_t done = 0;
+	while (done < batch.length)
+	{
+		ssize_t n = ::write(batch.fd, batch.data + done, batch.length - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break; // çıktı kapalı, kayıtlar kaybolur
+		done += n;
+	}
+	batch.length = 0;
+}
+
+// "2026-10-18T09:15:02.123Z INFO net: text\n"; saniye kısmı değişince yeniden yazılır
+static void format(LogBatch &batch, unsigned long long time, int level, int subsystem, const char *text, size_t len)
+{
+	static time_t stampSecond = -1;
+	static char stamp[32];
+	time_t second = time / 1000;
+	if (second != stampSecond)
+	{
+		struct tm parts;
+		gmtime_r(&second, &parts);
+		strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &parts);
+		stampSecond = second;
+	}
+	char head[64];
+	int headLen = std::snprintf(head, sizeof(head), "%s.%03uZ %s %s: ", stamp, (unsigned)(time % 1000),
+		levelNames[level], subsystemNames[subsystem]);
+	if (batch.length + headLen + len + 1 > sizeof(batch.data))
+		flush(batch);
+	std::memcpy(batch.data + batch.length, head, headLen);
+	std::memcpy(batch.data + batch.length + headLen, text, len);
+	batch.length += headLen + len;
+	batch.data[batch.length++] = '\n';
+}
+
+static unsigned long long wallMs()
+{
+	if (clockMs)
+		return clockMs;
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (unsigned long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static bool ready()
+{
+	return ring[dequeuePos & (LOG_RING_SLOTS - 1)].sequence == dequeuePos + 1;
+}
+
+// sıradaki dolu slotları metne çevirir; dönen değer işlenen kayıt sayısı
+static size_t drain(bool final)
+{
+	size_t count = 0;
+	static unsigned long reportedDrops = 0;
+	static unsigned long long reportedAt = 0;
+	for (;;)
+	{
+		LogSlot &slot = ring[dequeuePos & (LOG_RING_SLOTS - 1)];
+		if (slot.sequence != dequeuePos + 1)
+			break; // boş ya da üretici henüz yazıyor
+		__sync_synchronize();
+		format(slot.level >= Log::WARN ? err : out, slot.time, slot.level, slot.subsystem, slot.text, slot.length);
+		__sync_synchronize();
+		slot.sequence = dequeuePos + LOG_RING_SLOTS; // bir tur sonraki üreticiye açık
+		++dequeuePos;
+		++count;
+	}
+	__sync_fetch_and_add(&counters.written, count);
+	// atılan kayıtlar saniyede en fazla bir satırla bildirilir
+	unsigned long dropped = counters.dropped;
+	if (dropped != reportedDrops && (final || wallMs() - reportedAt >= LOG_IDLE_MS))
+	{
+		char text[64];
+		int len = std::snprintf(text, sizeof(text), "%lu records dropped, ring full", dropped - reportedDrops);
+		format(err, wallMs(), Log::WARN, Log::CORE, text, len);
+		reportedDrops = dropped;
+		reportedAt = wallMs();
+	}
+	if (out.length)
+		flush(out);
+	if (err.length)
+		flush(err);
+	return count;
+}
+
+// Trafik varken LOG_FLUSH_MS'de bir toplu yazar, ring yarıya dolunca üretici erken
+// uyandırır. LOG_IDLE_MS boyunca kayıt gelmezse ilk kayda kadar uyur, boştaki
+// sunucuyu uyandırmaz.
+static void *writerMain(void *)
+{
+	int quietTurns = 0;
+	pthread_mutex_lock(&wakeLock);
+	while (running)
+	{
+		pthread_mutex_unlock(&wakeLock);
+		quietTurns = drain(false) ? 0 : quietTurns + 1;
+		pthread_mutex_lock(&wakeLock);
+		if (quietTurns >= LOG_IDLE_MS / LOG_FLUSH_MS)
+		{
+			sleeping = true;
+			__sync_synchronize();
+			while (running && !ready())
+				pthread_cond_wait(&wake, &wakeLock);
+			sleeping = false;
+			quietTurns = 0;
+			continue;
+		}
+		struct timespec deadline;
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_nsec += LOG_FLUSH_MS * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec += 1;
+			deadline.tv_nsec -= 1000000000L;
+		}
+		if (running)
+			pthread_cond_timedwait(&wake, &wakeLock, &deadline);
+	}
+	pthread_mutex_unlock(&wakeLock);
+	drain(false);
+	return NULL;
+}
+
+static void wakeWriter()
+{
+	pthread_mutex_lock(&wakeLock);
+	pthread_cond_signal(&wake);
+	pthread_mutex_unlock(&wakeLock);
+}
+
+static int parseLevel(const std::string &name)
+{
+	for (int level = Log::DEBUG; level <= Log::OFF; ++level)
+		if (strcasecmp(name.c_str(), levelNames[level]) == 0)
+			return level;
+	throw std::runtime_error("Unknown log level: " + name);
+}
+
+void Log::configure(const std::string &spec)
+{
+	for (size_t start = 0; start <= spec.size(); )
+	{
+		size_t comma = spec.find(',', start);
+		if (comma == std::string::npos)
+			comma = spec.size();
+		std::string item = spec.substr(start, comma - start);
+		start = comma + 1;
+		size_t eq = item.find('=');
+		if (eq == std::string::npos)
+		{
+			// tek seviye tüm alt sistemlere
+			int level = parseLevel(item);
+			for (int i = 0; i < SUBSYSTEM_COUNT; ++i)
+				thresholds[i] = level;
+			continue;
+		}
+		std::string name = item.substr(0, eq);
+		int subsystem = 0;
+		while (subsystem < SUBSYSTEM_COUNT && name != subsystemNames[subsystem])
+			++subsystem;
+		if (subsystem == SUBSYSTEM_COUNT)
+			throw std::runtime_error("Unknown log subsystem: " + name);
+		thresholds[subsystem] = parseLevel(item.substr(eq + 1));
+	}
+}
+
+void Log::setTime(unsigned long long ms)
+{
+	clockMs = ms;
+}
+
+void Log::write(Subsystem subsystem, Level level, const char *text, size_t len, bool truncated)
+{
+	if (truncated)
+		__sync_fetch_and_add(&counters.truncated, 1);
+	if (!running)
+	{
+		// writer yok: doğrudan, tek thread'liyken (başlangıç, kapanış, testler)
+		LogBatch &batch = level >= WARN ? err : out;
+		format(batch, wallMs(), level, subsystem, text, len);
+		flush(batch);
+		__sync_fetch_and_add(&counters.logged, 1);
+		__sync_fetch_and_add(&counters.written, 1);
+		return;
+	}
+	unsigned long pos;
+	LogSlot *slot;
+	for (;;)
+	{
+		pos = enqueuePos;
+		slot = &ring[pos & (LOG_RING_SLOTS - 1)];
+		long diff = (long)(slot->sequence - pos);
+		if (diff < 0)
+		{
+			// writer bir tur geride: kayıt atılır, üretici beklemez
+			__sync_fetch_and_add(&counters.dropped, 1);
+			return;
+		}
+		if (diff == 0 && __sync_bool_compare_and_swap(&enqueuePos, pos, pos + 1))
+			break;
+	}
+	slot->time = clockMs ? clockMs : wallMs();
+	slot->level = level;
+	slot->subsystem = subsystem;
+	slot->length = len;
+	std::memcpy(slot->text, text, len);
+	__sync_synchronize();
+	slot->sequence = pos + 1;
+	__sync_fetch_and_add(&counters.logged, 1);
+	__sync_synchronize();
+	// uyuyan writer her kayıtta, bekleyen writer ring yarıyı geçtiği anda uyandırılır
+	if (sleeping || pos - dequeuePos == LOG_RING_SLOTS / 2)
+		wakeWriter();
+}
+
+void Log::start()
+{
+	if (running)
+		return;
+	for (unsigned long i = 0; i < LOG_RING_SLOTS; ++i)
+		ring[i].sequence = enqueuePos + i;
+	dequeuePos = enqueuePos;
+	running = true;
+	if (pthread_create(&writer, NULL, writerMain, NULL) != 0)
+		running = false;
+}
+
+void Log::stop()
+{
+	if (!running)
+		return;
+	pthread_mutex_lock(&wakeLock);
+	running = false;
+	pthread_cond_signal(&wake);
+	pthread_mutex_unlock(&wakeLock);
+	pthread_join(writer, NULL);
+	drain(true); // join ile durdurma arasında sıraya girenler ve son atılan sayısı
+}
+
+LogStats Log::stats()
+{
+	return counters;
+}
+
+LogLine::LogLine(Log::Subsystem subsystem, Log::Level level)
+	: subsystem(subsystem), level(level), length(0), truncated(false)
+{
+}
+
+LogLine::~LogLine()
+{
+	Log::write(this->subsystem, this->level, this->text, this->length, this->truncated);
+}
+
+LogLine &LogLine::append(const char *data, size_t len)
+{
+	size_t room = LOG_LINE_MAX - this->length;
+	if (len > room)
+	{
+		len = room;
+		this->truncated = true;
+	}
+	std::memcpy(this->text + this->length, data, len);
+	this->length += len;
+	return *this;
+}
+
+LogLine &LogLine::operator<<(const std::string &s) { return append(s.data(), s.size()); }
+LogLine &LogLine::operator<<(const char *s) { return append(s, std::strlen(s)); }
+LogLine &LogLine::operator<<(const IrcSpan &s) { return append(s.data, s.len); }
+LogLine &LogLine::operator<<(char c) { return append(&c, 1); }
+
+LogLine &LogLine::operator<<(int n)
+{
+	char digits[16];
+	return append(digits, std::snprintf(digits, sizeof(digits), "%d", n));
+}
+
+LogLine &LogLine::operator<<(unsigned long n)
+{
+	char digits[24];
+	return append(digits, std::snprintf(digits, sizeof(digits), "%lu", n));
+}
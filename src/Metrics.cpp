@@ -0,0 +1,91 @@
+#include "../include/Metrics.hpp"
+#include <cstdio>
+
+static const char *reasonNames[] = { "closed", "error", "ping_timeout", "registration_timeout", "idle_timeout", "sendq" };
+
+ConnectionStats::ConnectionStats() : accepted(0), scrapes(0)
+{
+	for (int i = 0; i < DISCONNECT_REASONS; ++i)
+		this->disconnects[i] = 0;
+}
+
+const char *ConnectionStats::reasonName(int reason)
+{
+	return reasonNames[reason];
+}
+
+MetricsScrape::MetricsScrape(int fd) : fd(fd), answered(false)
+{
+}
+
+bool MetricsScrape::isHttp() const
+{
+	size_t end = this->request.find('\n');
+	size_t version = this->request.rfind(" HTTP/", end);
+	return version != std::string::npos;
+}
+
+// "GET /metrics HTTP/1.1" başlıklarıyla boş satıra kadar; "\n" ya da başka tek satır hemen cevaplanır
+bool MetricsScrape::complete() const
+{
+	if (this->request.find('\n') == std::string::npos)
+		return false;
+	if (!isHttp())
+		return true;
+	return this->request.find("\r\n\r\n") != std::string::npos || this->request.find("\n\n") != std::string::npos;
+}
+
+MetricsText::MetricsText(std::string &out) : out(out)
+{
+}
+
+void MetricsText::family(const char *metric, const char *type, const char *help)
+{
+	this->out.append("# HELP ").append(metric).append(" ").append(help).append("\n");
+	this->out.append("# TYPE ").append(metric).append(" ").append(type).append("\n");
+}
+
+void MetricsText::name(const char *metric, const std::string &labels)
+{
+	this->out.append(metric);
+	if (!labels.empty())
+		this->out.append("{").append(labels).append("}");
+	this->out += ' ';
+}
+
+void MetricsText::sample(const char *metric, const std::string &labels, unsigned long long value)
+{
+	char text[24];
+	name(metric, labels);
+	this->out.append(text, std::snprintf(text, sizeof(text), "%llu\n", value));
+}
+
+void MetricsText::sample(const char *metric, const std::string &labels, double value)
+{
+	char text[32];
+	name(metric, labels);
+	this->out.append(text, std::snprintf(text, sizeof(text), "%.9g\n", value));
+}
+
+// key="value"; değerdeki \, " ve satır sonu kaçırılır
+std::string MetricsText::label(const char *key, const std::string &value)
+{
+	std::string text(key);
+	text += "=\"";
+	for (size_t i = 0; i < value.size(); ++i)
+	{
+		if (value[i] == '\\' || value[i] == '"')
+			text += '\\';
+		if (value[i] == '\n')
+			text += "\\n";
+		else
+			text += value[i];
+	}
+	text += '"';
+	return text;
+}
+
+std::string MetricsText::label(const char *key, const std::string &value, const char *key2, const std::string &value2)
+{
+	return label(key, value) + "," + label(key2, value2);
+}
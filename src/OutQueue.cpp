@@ -0,0 +1,250 @@
+#include "../include/OutQueue.hpp"
+#include <climits>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <cstring>
+
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+// özel cevaplar bu boyuta kadar kuyruğun son bloğuna eklenir
+#define TAIL_JOIN_LIMIT 4096
+// thread başına en fazla bu kadar boş blok saklanır; büyümüş olanlar saklanmaz
+#define SPARE_BLOCKS 64
+#define SPARE_CAPACITY (2 * TAIL_JOIN_LIMIT)
+
+static size_t liveMessages = 0;
+// her thread kendi bloklarını açıp bırakır, liste thread'e özel
+static __thread SharedMessage *spareBlocks = NULL;
+static __thread size_t spareCount = 0;
+
+// ---------- SharedMessage ----------
+
+// worker thread'leri de kendi kuyruklarında blok açar, sayaç atomik
+SharedMessage::SharedMessage() : refs(1), lines(0), nextSpare(NULL)
+{
+	__sync_add_and_fetch(&liveMessages, 1);
+}
+
+SharedMessage::~SharedMessage()
+{
+	__sync_sub_and_fetch(&liveMessages, 1);
+}
+
+SharedMessage *SharedMessage::create()
+{
+	SharedMessage *msg = spareBlocks;
+	if (!msg)
+		return new SharedMessage();
+	spareBlocks = msg->nextSpare;
+	--spareCount;
+	msg->refs = 1;
+	return msg;
+}
+
+SharedMessage *SharedMessage::create(const std::string &line)
+{
+	SharedMessage *msg = create();
+	msg->bytes.assign(line);
+	msg->lines = 1;
+	return msg;
+}
+
+void SharedMessage::retain()
+{
+	++this->refs;
+}
+
+void SharedMessage::release()
+{
+	if (--this->refs > 0)
+		return;
+	if (spareCount >= SPARE_BLOCKS || this->bytes.capacity() > SPARE_CAPACITY)
+	{
+		delete this;
+		return;
+	}
+	// kapasite korunur, bir sonraki create() heap'e gitmez
+	this->bytes.clear();
+	this->lines = 0;
+	this->nextSpare = spareBlocks;
+	spareBlocks = this;
+	++spareCount;
+}
+
+void SharedMessage::releaseSpares()
+{
+	while (spareBlocks)
+	{
+		SharedMessage *msg = spareBlocks;
+		spareBlocks = msg->nextSpare;
+		delete msg;
+	}
+	spareCount = 0;
+}
+
+bool SharedMessage::unique() const { return this->refs == 1; }
+void SharedMessage::append(const std::string &line) { this->bytes += line; ++this->lines; }
+void SharedMessage::swap(std::string &other, size_t lineCount) { this->bytes.swap(other); this->lines = lineCount; }
+std::string &SharedMessage::text() { return this->bytes; }
+void SharedMessage::addLine() { ++this->lines; }
+const char *SharedMessage::data() const { return this->bytes.data(); }
+size_t SharedMessage::size() const { return this->bytes.size(); }
+size_t SharedMessage::lineCount() const { return this->lines; }
+size_t SharedMessage::liveCount() { return __sync_add_and_fetch(&liveMessages, 0); }
+
+// ---------- OutQueue ----------
+
+OutQueue::OutQueue() : headBlock(0), headOffset(0), total(0), messages(0) {}
+
+OutQueue::~OutQueue()
+{
+	clear();
+}
+
+void OutQueue::push(SharedMessage *msg)
+{
+	if (msg->size() == 0)
+		return;
+	msg->retain();
+	blocks.push_back(msg);
+	total += msg->size();
+	messages += msg->lineCount();
+}
+
+void OutQueue::push(const std::string &line)
+{
+	if (line.empty())
+		return;
+	SharedMessage *tail = joinableTail();
+	if (tail)
+		tail->append(line);
+	else
+		blocks.push_back(SharedMessage::create(line));
+	total += line.size();
+	++messages;
+}
+
+// son blok sadece bize aitse (yayın değilse) yeni blok açmadan eklenebilir
+SharedMessage *OutQueue::joinableTail()
+{
+	if (headBlock == blocks.size())
+		return NULL;
+	SharedMessage *tail = blocks.back();
+	if (!tail->unique() || tail->size() >= TAIL_JOIN_LIMIT)
+		return NULL;
+	return tail;
+}
+
+void OutQueue::grewTail(size_t bytes)
+{
+	total += bytes;
+	++messages;
+}
+
+void OutQueue::adopt(std::string &bytes, size_t lines)
+{
+	if (bytes.empty())
+		return;
+	SharedMessage *msg = SharedMessage::create();
+	msg->swap(bytes, lines);
+	blocks.push_back(msg);
+	total += msg->size();
+	messages += lines;
+}
+
+bool OutQueue::empty() const { return this->total == 0; }
+size_t OutQueue::size() const { return this->total; }
+size_t OutQueue::messageCount() const { return this->messages; }
+size_t OutQueue::blockCount() const { return this->blocks.size() - this->headBlock; }
+
+const char *OutQueue::front(size_t &len) const
+{
+	if (headBlock == blocks.size())
+	{
+		len = 0;
+		return NULL;
+	}
+	len = blocks[headBlock]->size() - headOffset;
+	return blocks[headBlock]->data() + headOffset;
+}
+
+void OutQueue::consume(size_t n)
+{
+	total -= n;
+	while (n > 0 && headBlock < blocks.size())
+	{
+		size_t left = blocks[headBlock]->size() - headOffset;
+		if (n < left)
+		{
+			headOffset += n;
+			break;
+		}
+		n -= left;
+		messages -= blocks[headBlock]->lineCount();
+		blocks[headBlock++]->release();
+		headOffset = 0;
+	}
+	// gönderilmiş işaretçiler ara sıra topluca atılır; kapasite korunur
+	if (headBlock == blocks.size())
+	{
+		blocks.clear();
+		headBlock = 0;
+	}
+	else if (headBlock >= 64 && headBlock * 2 >= blocks.size())
+	{
+		blocks.erase(blocks.begin(), blocks.begin() + headBlock);
+		headBlock = 0;
+	}
+}
+
+ssize_t OutQueue::writeTo(int fd, size_t &offered)
+{
+	struct iovec iov[IOV_MAX];
+	size_t count = 0;
+	offered = 0;
+	for (size_t i = headBlock; i < blocks.size() && count < IOV_MAX; ++i, ++count)
+	{
+		size_t skip = (i == headBlock) ? headOffset : 0;
+		iov[count].iov_base = const_cast<char *>(blocks[i]->data() + skip);
+		iov[count].iov_len = blocks[i]->size() - skip;
+		offered += iov[count].iov_len;
+	}
+	struct msghdr msg;
+	std::memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = count;
+	// kapanmış sokete yazmak SIGPIPE ile süreci öldürmesin
+	ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+	if (sent > 0)
+		consume(sent);
+	return sent;
+}
+
+void OutQueue::moveTo(std::string &out)
+{
+	out.clear();
+	out.reserve(total);
+	size_t len;
+	while (headBlock < blocks.size())
+	{
+		const char *p = front(len);
+		out.append(p, len);
+		consume(len);
+	}
+}
+
+void OutQueue::clear()
+{
+	for (size_t i = headBlock; i < blocks.size(); ++i)
+		blocks[i]->release();
+	blocks.clear();
+	headBlock = 0;
+	headOffset = 0;
+	total = 0;
+	messages = 0;
+}
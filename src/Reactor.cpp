@@ -0,0 +1,220 @@
+#include "../include/Reactor.hpp"
+#include "../include/Log.hpp"
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <algorithm>
+
+Reactor::~Reactor() {}
+
+void Reactor::addListener(int fd)
+{
+	add(fd, READ);
+}
+
+bool Reactor::completionBased() const
+{
+	return false;
+}
+
+bool Reactor::submitSend(int fd, OutQueue &queue)
+{
+	(void)fd;
+	(void)queue;
+	return false;
+}
+
+Reactor *Reactor::create(const std::string &backend)
+{
+	if (backend == "uring")
+	{
+#ifdef HAVE_IO_URING
+		try
+		{
+			return new UringReactor();
+		}
+		catch (const std::exception &e)
+		{
+			LOG(CORE, WARN) << "io_uring unavailable (" << e.what() << "), falling back";
+		}
+#else
+		LOG(CORE, WARN) << "io_uring not compiled in, falling back";
+#endif
+		return create("auto");
+	}
+#if defined(__linux__)
+	if (backend == "epoll" || backend == "auto")
+		return new EpollReactor();
+#endif
+	if (backend == "poll" || backend == "auto")
+		return new PollReactor();
+	throw(std::runtime_error("Unsupported event backend: " + backend));
+}
+
+// ---------- poll ----------
+
+static short toPollEvents(unsigned int events)
+{
+	short ev = 0;
+	if (events & Reactor::READ)
+		ev |= POLLIN;
+	if (events & Reactor::WRITE)
+		ev |= POLLOUT;
+	return ev;
+}
+
+PollReactor::PollReactor() {}
+
+PollReactor::~PollReactor() {}
+
+const char *PollReactor::name() const { return "poll"; }
+
+int PollReactor::find(int fd) const
+{
+	if (fd < 0 || (size_t)fd >= slots.size())
+		return -1;
+	return slots[fd];
+}
+
+void PollReactor::add(int fd, unsigned int events)
+{
+	if ((size_t)fd >= slots.size())
+		slots.resize(std::max((size_t)fd + 1, slots.size() * 2), -1);
+	struct pollfd p;
+	p.fd = fd;
+	p.events = toPollEvents(events);
+	p.revents = 0;
+	slots[fd] = pfds.size();
+	pfds.push_back(p);
+}
+
+void PollReactor::modify(int fd, unsigned int events)
+{
+	int i = find(fd);
+	if (i >= 0)
+		pfds[i].events = toPollEvents(events);
+}
+
+// swap-remove: son pollfd boşalan slota taşınır, kaydırma yok
+void PollReactor::remove(int fd)
+{
+	int i = find(fd);
+	if (i < 0)
+		return;
+	pfds[i] = pfds.back();
+	slots[pfds[i].fd] = i;
+	pfds.pop_back();
+	slots[fd] = -1;
+}
+
+int PollReactor::wait(std::vector<ReactorEvent> &ready, int timeoutMs)
+{
+	ready.clear();
+	int n = poll(pfds.empty() ? NULL : &pfds[0], pfds.size(), timeoutMs);
+	if (n <= 0)
+		return n;
+	for (size_t i = 0; i < pfds.size() && (int)ready.size() < n; ++i)
+	{
+		if (!pfds[i].revents)
+			continue;
+		ReactorEvent ev;
+		ev.fd = pfds[i].fd;
+		ev.events = 0;
+		ev.result = 0;
+		ev.data = NULL;
+		if (pfds[i].revents & POLLIN)
+			ev.events |= READ;
+		if (pfds[i].revents & POLLOUT)
+			ev.events |= WRITE;
+		if (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL))
+			ev.events |= ERROR;
+		ready.push_back(ev);
+	}
+	return ready.size();
+}
+
+// ---------- epoll ----------
+
+#if defined(__linux__)
+
+static uint32_t toEpollEvents(unsigned int events)
+{
+	uint32_t ev = 0;
+	if (events & Reactor::READ)
+		ev |= EPOLLIN;
+	if (events & Reactor::WRITE)
+		ev |= EPOLLOUT;
+	return ev;
+}
+
+EpollReactor::EpollReactor() : registered(0), events(64)
+{
+	this->epfd = epoll_create(1);
+	if (this->epfd == -1)
+		throw(std::runtime_error("epoll_create failed."));
+}
+
+EpollReactor::~EpollReactor()
+{
+	close(this->epfd);
+}
+
+const char *EpollReactor::name() const { return "epoll"; }
+
+void EpollReactor::add(int fd, unsigned int ev)
+{
+	struct epoll_event e;
+	e.events = toEpollEvents(ev);
+	e.data.u64 = 0;
+	e.data.fd = fd;
+	if (epoll_ctl(this->epfd, EPOLL_CTL_ADD, fd, &e) == -1)
+		throw(std::runtime_error("epoll_ctl ADD failed."));
+	// grow the event table with the registration count so one wait can drain everything
+	++registered;
+	if (registered > events.size())
+		events.resize(events.size() * 2);
+}
+
+void EpollReactor::modify(int fd, unsigned int ev)
+{
+	struct epoll_event e;
+	e.events = toEpollEvents(ev);
+	e.data.u64 = 0;
+	e.data.fd = fd;
+	epoll_ctl(this->epfd, EPOLL_CTL_MOD, fd, &e);
+}
+
+void EpollReactor::remove(int fd)
+{
+	struct epoll_event e;
+	std::memset(&e, 0, sizeof(e));
+	if (epoll_ctl(this->epfd, EPOLL_CTL_DEL, fd, &e) == 0 && registered > 0)
+		--registered;
+}
+
+int EpollReactor::wait(std::vector<ReactorEvent> &ready, int timeoutMs)
+{
+	ready.clear();
+	int n = epoll_wait(this->epfd, &events[0], events.size(), timeoutMs);
+	if (n <= 0)
+		return n;
+	for (int i = 0; i < n; ++i)
+	{
+		ReactorEvent ev;
+		ev.fd = events[i].data.fd;
+		ev.events = 0;
+		ev.result = 0;
+		ev.data = NULL;
+		if (events[i].events & EPOLLIN)
+			ev.events |= READ;
+		if (events[i].events & EPOLLOUT)
+			ev.events |= WRITE;
+		if (events[i].events & (EPOLLERR | EPOLLHUP))
+			ev.events |= ERROR;
+		ready.push_back(ev);
+	}
+	return n;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "../include/Reply.hpp"
+#include <cstring>
+
+Reply::Reply(Client &to) : client(&to), block(NULL), out(NULL), start(0), joined(false)
+{
+	// SendQ'su aşılmış client'a yazılan satır kuyruğa girmez, ayrı blokta kalır
+	if (!to.getSendQExcess())
+		this->block = to.outbuf.joinableTail();
+	this->joined = this->block != NULL;
+	if (!this->block)
+		this->block = SharedMessage::create();
+	this->out = &this->block->text();
+	this->start = this->out->size();
+}
+
+Reply::Reply() : client(NULL), block(SharedMessage::create()), out(NULL), start(0), joined(false)
+{
+	this->out = &this->block->text();
+}
+
+Reply::~Reply()
+{
+	if (!this->block)
+		return;
+	if (this->joined)
+		this->out->resize(this->start);
+	else
+		this->block->release();
+}
+
+Reply &Reply::operator<<(const std::string &s)
+{
+	this->out->append(s);
+	return *this;
+}
+
+Reply &Reply::operator<<(const char *s)
+{
+	this->out->append(s, std::strlen(s));
+	return *this;
+}
+
+Reply &Reply::operator<<(char c)
+{
+	this->out->push_back(c);
+	return *this;
+}
+
+Reply &Reply::numeric(const char *code, const Client &to)
+{
+	*this << ":server " << code << ' ';
+	if (to.getNick().empty())
+		return *this << '*';
+	return *this << to.getNick();
+}
+
+void Reply::finish()
+{
+	this->out->append("\r\n", 2);
+	this->block->addLine();
+}
+
+void Reply::send()
+{
+	if (!this->block || !this->client)
+		return;
+	finish();
+	if (this->joined)
+		this->client->queueTail(this->out->size() - this->start);
+	else
+	{
+		this->client->queue(this->block);
+		this->block->release();
+	}
+	this->block = NULL;
+}
+
+SharedMessage *Reply::take()
+{
+	if (!this->block)
+		return NULL;
+	finish();
+	SharedMessage *taken = this->block;
+	this->block = NULL;
+	return taken;
+}
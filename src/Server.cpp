@@ -3,34 +3,114 @@
 Server::Server()
 {
 	this->serverFd = 0;
-	this->num_of_pfd = 0;
+	this->reactor = NULL;
+	this->backend = "auto";
 	this->running = true;
-	
-	// pfds array'ini initialize et
-	std::memset(this->pfds, 0, sizeof(this->pfds));
+	this->workerCount = 0;
+	this->coreInbox = NULL;
+	this->trimTimer.kind = TIMER_TRIM;
+	updateClock();
+	this->created = this->clock.wallSeconds();
+	this->pingInterval = PING_INTERVAL;
+	this->pingTimeout = PING_TIMEOUT;
+	this->registrationTimeout = REGISTRATION_TIMEOUT;
+	this->idleTimeout = 0;
+	this->commandStats.resize(commandCount());
+	this->slowMs = SLOW_THRESHOLD_MS;
+	this->metricsFd = -1;
+	this->channelOrderStale = false;
+
+	SendQClass unregistered = { "unregistered", 64 * 1024, 256, 0, 0 };
+	SendQClass user = { "user", 1024 * 1024, 8192, 0, 0 };
+	this->sendq[SendQClass::UNREGISTERED] = unregistered;
+	this->sendq[SendQClass::USER] = user;
 }
 
 Server::~Server()
 {
+    stopWorkers();
+
     // Tüm kanalları temizle
-    for (std::map<std::string, Channel*>::iterator it = channels.begin(); it != channels.end(); ++it)
+    for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it)
     {
-        delete it->second;
+        channelPool.destroy(it->second);
     }
     channels.clear();
     
     // Tüm clientları temizle
     for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
     {
-        if ((*it)->getFd() > 0)
+        // worker modunda soketleri worker'lar kapatır
+        if ((*it)->getFd() > 0 && workers.empty())
             close((*it)->getFd());
-        delete *it;
+        clientPool.destroy(*it);
     }
     clients.clear();
     
+    for (size_t i = 0; i < workers.size(); ++i)
+        delete workers[i];
+    workers.clear();
+    delete coreInbox;
+
     // Server socket'ını kapat
     if (serverFd > 0)
         close(serverFd);
+    closeMetrics();
+    delete reactor;
+    SharedMessage::releaseSpares();
+    BufferPool::releaseAll();
+}
+
+void Server::setBackend(const std::string &name)
+{
+	this->backend = name;
+}
+
+void Server::setWorkers(int count)
+{
+	this->workerCount = count;
+}
+
+// "sınıf=byte[:mesaj]", örn. "user=2097152:16384"
+void Server::setSendQ(const std::string &spec)
+{
+	size_t eq = spec.find('=');
+	if (eq == std::string::npos)
+		throw(std::runtime_error("--sendq expects class=bytes[:messages]"));
+	std::string name = spec.substr(0, eq);
+	int id = -1;
+	for (int i = 0; i < SendQClass::COUNT; i++)
+	{
+		if (name == this->sendq[i].name)
+			id = i;
+	}
+	if (id < 0)
+		throw(std::runtime_error("Unknown sendq class: " + name));
+
+	char *end = NULL;
+	const char *value = spec.c_str() + eq + 1;
+	unsigned long bytes = std::strtoul(value, &end, 10);
+	unsigned long messages = this->sendq[id].maxMessages;
+	if (*end == ':')
+		messages = std::strtoul(end + 1, &end, 10);
+	if (end == value || *end != '\0' || bytes == 0 || messages == 0)
+		throw(std::runtime_error("Invalid --sendq value: " + spec));
+	this->sendq[id].maxBytes = bytes;
+	this->sendq[id].maxMessages = messages;
+}
+
+// "ad:parola"; OPER ad parola ile eşleşen client operatör olur
+void Server::addOper(const std::string &spec)
+{
+	size_t colon = spec.find(':');
+	if (colon == 0 || colon == std::string::npos || colon + 1 == spec.size())
+		throw(std::runtime_error("--oper expects name:password"));
+	this->operators[spec.substr(0, colon)] = spec.substr(colon + 1);
+}
+
+const SendQClass *Server::getSendQ() const
+{
+	return this->sendq;
 }
 
 void setNonBlocking(int fd)
@@ -42,9 +122,9 @@ void setNonBlocking(int fd)
 		throw(std::runtime_error("Failed while setting socket non-blocking."));
 }
 
+// sinyal handler'ından çağrılır: yalnızca bayrak; log (mutex, condvar) döngü bitince start()'ta
 void Server::stop()
 {
-    std::cout << "Stopping server gracefully..." << std::endl;
     this->running = false;
 }
 
@@ -60,7 +140,7 @@ void Server::initServer(struct sockaddr_in &hints, int port)
 	this->serverFd = socket(AF_INET, SOCK_STREAM, 0);
 	if (this->serverFd == -1)
 	{
-		std::cerr << "SOCKET ERROR" << std::endl;
+		LOG(CORE, ERROR) << "Socket error: " << strerror(errno);
 		throw std::exception();
 	}
 	
@@ -76,174 +156,474 @@ void Server::initServer(struct sockaddr_in &hints, int port)
 		throw(std::runtime_error("Error while listening socket."));
 	setNonBlocking(this->serverFd);
 	
-	std::cout << "IRC Server Has Been Running!" << std::endl;
-	
-	this->pfds[0].fd = this->serverFd;
-	this->pfds[0].events = POLLIN;
-	this->num_of_pfd++;
-	
+	this->reactor = Reactor::create(this->backend);
+	this->reactor->addListener(this->serverFd);
 
+	LOG(CORE, INFO) << "IRC Server Has Been Running! (" << this->reactor->name() << ")";
 }
 
-void Server::removeClient(int index)
+Client *Server::findClient(int fd)
 {
-	Client* clientToRemove = NULL;
-	
-	// Önce silinecek client'ı bul
-	for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
+	if (fd < 0 || (size_t)fd >= connections.size())
+		return NULL;
+	return connections[fd].client;
+}
+
+// bağlantının Client'ı havuzdan alınır; removeClient havuza geri verir
+Client *Server::addClient(int clientFd, int worker)
+{
+	Client *cl = clientPool.create(clientFd);
+	size_t fd = clientFd;
+	if (fd >= connections.size())
 	{
-		if ((*it)->getFd() == pfds[index].fd)
-		{
-			clientToRemove = *it;
-			break;
-		}
+		Connection empty;
+		empty.client = NULL;
+		empty.index = 0;
+		empty.worker = -1;
+		connections.resize(std::max(fd + 1, connections.size() * 2), empty);
+	}
+	connections[fd].client = cl;
+	connections[fd].index = clients.size();
+	connections[fd].worker = worker;
+	clients.push_back(cl);
+	cl->setPendingList(&pendingWrites);
+	cl->setSendQClasses(this->sendq);
+	cl->setLastInput(this->clock.monotonicMs());
+	cl->setLastActivity(this->clock.monotonicMs());
+	cl->setSignon(this->clock.wallSeconds());
+	// kayıt bitene kadar kayıt süresi, sonra keepalive
+	Timer &timer = cl->getTimer();
+	timer.kind = TIMER_CLIENT;
+	timer.data = cl;
+	this->timers.schedule(timer, this->clock.monotonicMs() + this->registrationTimeout * 1000ULL);
+	return cl;
+}
+
+const PoolStats &Server::getClientPoolStats() const { return clientPool.stats(); }
+const PoolStats &Server::getChannelPoolStats() const { return channelPool.stats(); }
+
+// bağlantılarda bekleyen (okunmuş ama işlenmemiş, kuyruğa alınmış ama gönderilmemiş) byte'lar
+size_t Server::bufferedBytes() const
+{
+	size_t total = 0;
+	for (size_t i = 0; i < clients.size(); ++i)
+		total += clients[i]->bufferedBytes();
+	return total;
+}
+
+void Server::setTimeouts(int ping, int pingTimeout, int registration)
+{
+	if (ping > 0)
+		this->pingInterval = ping;
+	if (pingTimeout > 0)
+		this->pingTimeout = pingTimeout;
+	if (registration > 0)
+		this->registrationTimeout = registration;
+}
+
+void Server::setSlowThreshold(int ms)
+{
+	this->slowMs = ms;
+}
+
+void Server::setIdleTimeout(int seconds)
+{
+	this->idleTimeout = std::max(seconds, 0);
+}
+
+const Clock &Server::getClock() const { return this->clock; }
+
+// döngü turu başına bir kez; komutlar ve timer'lar bu değeri kullanır
+void Server::updateClock()
+{
+	this->clock.update();
+	Log::setTime(this->clock.wallMs());
+}
+
+// süresi dolan timer'lar; reactor'ın bekleme süresi bir sonrakinden hesaplanır
+void Server::runTimers()
+{
+	this->timers.advance(this->clock.monotonicMs());
+	while (Timer *timer = this->timers.nextExpired())
+	{
+		if (timer->kind == TIMER_CLIENT)
+			keepalive(*static_cast<Client *>(timer->data));
+		else if (timer->kind == TIMER_TRIM)
+			BufferPool::trim();
+		else if (timer->kind == TIMER_SCRAPE)
+			closeScrape(static_cast<MetricsScrape *>(timer->data)->fd);
+	}
+	// havuzda buffer kaldıkça kırpma sürer; boşsa reactor bu yüzden uyanmaz
+	if (!this->trimTimer.pending() && BufferPool::stats().cached)
+		this->timers.schedule(this->trimTimer, this->clock.monotonicMs() + BUFFER_TRIM_MS);
+}
+
+// Kayıt süresi dolmuşsa kapat. Kayıtlıysa: pingInterval boyunca sessiz kalana PING,
+// PING'den sonra pingTimeout içinde hiçbir şey gelmezse kapat; idleTimeout açıksa
+// o kadar süre PRIVMSG/NOTICE göndermeyeni de kapat. Okumalar ve mesajlar sadece
+// lastInput/lastActivity'yi yazar; timer'a yalnızca süresi dolunca bakılır.
+void Server::keepalive(Client &client)
+{
+	if (!client.getRegis())
+	{
+		disconnect(client, "Registration timeout", DISCONNECT_REGISTRATION);
+		return;
+	}
+	unsigned long long now = this->clock.monotonicMs();
+	unsigned long long last = client.getLastInput();
+	unsigned long long sent = client.getPingSent();
+	unsigned long long timeout = this->pingTimeout * 1000ULL;
+	bool waiting = sent && last < sent; // PING'e henüz cevap yok
+	if (waiting && now - sent >= timeout)
+	{
+		disconnect(client, "Ping timeout: " + to_string((now - last) / 1000) + " seconds", DISCONNECT_PING);
+		return;
+	}
+	unsigned long long idle = this->idleTimeout * 1000ULL;
+	if (idle && now - client.getLastActivity() >= idle)
+	{
+		disconnect(client, "Idle timeout: " + to_string(this->idleTimeout) + " seconds", DISCONNECT_IDLE);
+		return;
+	}
+	unsigned long long wake;
+	unsigned long long interval = this->pingInterval * 1000ULL;
+	if (waiting)
+		wake = sent + timeout; // idle süresi için erken uyandı
+	else if (now - last >= interval)
+	{
+		enqueue(client, "PING :server\r\n");
+		client.setPingSent(now);
+		wake = now + timeout;
 	}
+	else
+	{
+		client.setPingSent(0);
+		wake = last + interval;
+	}
+	if (idle)
+		wake = std::min(wake, client.getLastActivity() + idle);
+	this->timers.schedule(client.getTimer(), wake);
+}
+
+void Server::removeClient(int fd)
+{
+	Client* clientToRemove = findClient(fd);
 	
 	if (clientToRemove)
 	{
-		// Client'ı tüm kanallardan çıkar
-		for (std::map<std::string, Channel*>::iterator it = channels.begin(); it != channels.end(); )
-		{
-			Channel* channel = it->second;
-			if (channel->hasClient(clientToRemove))
-			{
-				channel->removeClient(clientToRemove);
-				
-				// Eğer kanal boş kaldıysa sil
-				if (channel->getMemberCount() == 0)
-				{
-					delete channel;
-					std::map<std::string, Channel*>::iterator toErase = it;
-					++it;
-					channels.erase(toErase);
-					continue;
-				}
-			}
-			++it;
-		}
+		// Client'ı yalnızca üye olduğu kanallardan çıkar
+		while (!clientToRemove->getChannels().empty())
+			leaveChannel(*clientToRemove->getChannels().begin(), *clientToRemove);
 		
-		// Client'ı clients vektöründen çıkar ve sil
-		for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
-		{
-			if (*it == clientToRemove)
-			{
-				delete *it;
-				clients.erase(it);
-				break;
-			}
-		}
+		NickMap::iterator nick = nicks.find(clientToRemove->getNick());
+		if (nick != nicks.end() && nick->second == clientToRemove)
+			nicks.erase(nick);
+
+		// clients vektöründen swap-remove: son elemanı boşalan yere taşı
+		size_t index = connections[fd].index;
+		Client *last = clients.back();
+		clients[index] = last;
+		connections[last->getFd()].index = index;
+		clients.pop_back();
+		connections[fd].client = NULL;
+		this->timers.cancel(clientToRemove->getTimer());
+		clientPool.destroy(clientToRemove);
 	}
 	
-	// Poll array'ını düzenle
-	for (int i = index; i < num_of_pfd - 1; i++)
-	{
-		pfds[i] = pfds[i + 1];
-	}
-	num_of_pfd--;
+	if (workers.empty())
+		this->reactor->remove(fd);
 }
 
 
 
-void Server::commandParser(Client &client, std::string &message)//single command parser
+void Server::commandParser(Client &client, const char *line, size_t len)//single command parser
 {
-	std::cout << "Processing command from client " << client.getFd() << ": " << message << std::endl;
-	
-	std::string cmd, trailing;
-	std::vector<std::string> params;
-	parseIrc(message, cmd, params, trailing);
-	
+	IrcSpan raw = { line, len };
+	LOG(CMD, DEBUG) << "Processing command from client " << client.getFd() << ": " << raw;
+
+	IrcMessage msg;
+	if (!parseMessage(line, len, msg))
+		return;
+
+	// handler'lar string ister; scratch'ler kapasitelerini korur, sabit durumda allocation yok
+	this->cmdScratch.assign(msg.command.data, msg.command.len);
+	size_t count = msg.paramCount;
 	// Trailing parametresi varsa params'a ekle
-	if (!trailing.empty()) {
-		params.push_back(trailing);
-	}
-	
-	commandHandler(cmd, params, client);
+	bool trailing = msg.hasTrailing && !msg.trailing.empty();
+	this->paramScratch.resize(count + (trailing ? 1 : 0));
+	for (size_t i = 0; i < count; i++)
+		this->paramScratch[i].assign(msg.params[i].data, msg.params[i].len);
+	if (trailing)
+		this->paramScratch[count].assign(msg.trailing.data, msg.trailing.len);
+
+	commandHandler(this->cmdScratch, this->paramScratch, client, len);
 }
 
-void Server::handleClient(int i)
+void Server::handleClient(int fd)
 {
-	char buffer[BUF_SIZE];//buffer yönetimine bak
-	int bytes = recv(this->pfds[i].fd, buffer, sizeof(buffer) - 1, 0);
-	if (bytes < 0)
+	Client *client = findClient(fd);
+	if (!client)
+		return;
+	// soket EAGAIN'e kadar okunur; bir client bir turda READ_BUDGET'tan fazlasını alamaz,
+	// kalan veri için reactor bir sonraki turda yine haber verir
+	size_t budget = READ_BUDGET;
+	while (budget > 0)
 	{
-		if (errno == EAGAIN || errno == EWOULDBLOCK)//bunun sayesinde halletti
+		ssize_t bytes = client->inbuf.readFrom(fd);
+		if (bytes < 0)
 		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK)//bunun sayesinde halletti
+				return;
+			LOG(NET, INFO) << "Client " << fd << " disconnected with error: " << strerror(errno);
+			++this->connStats.disconnects[DISCONNECT_ERROR];
+			removeClient(fd);
+			close(fd);
 			return;
 		}
-		else
+		if (bytes == 0)
 		{
-			std::cout << "Client disconnected with error: " << strerror(errno) << std::endl;
-			close(this->pfds[i].fd);
-			removeClient(i);
+			LOG(NET, INFO) << "Client " << fd << " disconnected";
+			++this->connStats.disconnects[DISCONNECT_CLOSED];
+			removeClient(fd);
+			close(fd);
 			return;
 		}
+		budget -= std::min(budget, (size_t)bytes);
+		processInput(*client);
 	}
-	else if (bytes == 0)
+}
+
+// Worker ve io_uring yolu: okunmuş veri ring'e sığdığı kadar parça parça işlenir
+void Server::feedInput(Client &client, const char *data, size_t len)
+{
+	while (len > 0)
 	{
-		std::cout << "Client disconnected" << std::endl;
-		close(this->pfds[i].fd);
-		removeClient(i);
-		return;
+		size_t taken = client.inbuf.append(data, len);
+		data += taken;
+		len -= taken;
+		processInput(client);
 	}
-	else
+}
+
+void Server::processInput(Client &client)
+{
+	client.setLastInput(this->clock.monotonicMs());
+	// Ring'deki tam komutları yerinde işle, baştan silme yok
+	const char *data;
+	size_t len;
+	int status;
+	while ((status = client.inbuf.nextLine(data, len)) != InputBuffer::NONE)
 	{
-		buffer[bytes] = '\0';
-		
-		// search for client and pass it to command parser
-		for (size_t j = 0; j < clients.size(); j++)
+		if (status == InputBuffer::TOO_LONG)
 		{
-			if (clients[j]->getFd() == pfds[i].fd)
-			{
-				// Gelen veriyi input buffer'a ekle
-				clients[j]->inbuf.append(buffer, bytes);
-				
-				// Buffer'da tam komutları ara ve işle
-				std::string& inputBuffer = clients[j]->inbuf;
-				size_t pos = 0;
-				
-				while ((pos = inputBuffer.find("\r\n")) != std::string::npos || 
-					   (pos = inputBuffer.find("\n")) != std::string::npos)
-				{
-					std::string line = inputBuffer.substr(0, pos);
-					inputBuffer.erase(0, pos + ((inputBuffer[pos] == '\r') ? 2 : 1));
-					
-					if (!line.empty())
-					{
-						std::cout << "Processing complete command from client " << clients[j]->getFd() << ": " << line << std::endl;
-						commandParser(*clients[j], line);
-					}
-				}
-				break;
-			}
+			std::string nickOrStar = client.getNick().empty() ? "*" : client.getNick();
+			enqueue(client, ":server 417 " + nickOrStar + " :Input line was too long\r\n");
+			continue;
+		}
+		if (len > 0)
+		{
+			commandParser(client, data, len);
 		}
 	}
-
 }
 
-bool Server::handleClientPollout(int i)
+bool Server::handleClientPollout(int fd)
 {
-	for (size_t j = 0; j < clients.size(); j++)
+	Client *client = findClient(fd);
+	if (this->reactor->completionBased())
+	{
+		// tek seferde bir send uçuşta; bitince WRITE gelir ve kalan gönderilir
+		if (client)
+			this->reactor->submitSend(fd, client->outbuf);
+		return false;
+	}
+	// her sendmsg IOV_MAX bloğa kadar gönderir; soket dolunca kalan için WRITE beklenir
+	while (client && !client->outbuf.empty())
 	{
-		if (clients[j]->getFd() == pfds[i].fd && !clients[j]->outbuf.empty())
+		size_t offered;
+		ssize_t sent = client->outbuf.writeTo(fd, offered);
+		if (sent > 0 && (size_t)sent == offered)
+			continue; // IOV_MAX'tan fazla blok vardı
+		if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
 		{
-			int sent = send(pfds[i].fd, clients[j]->outbuf.c_str(), clients[j]->outbuf.size(), 0);
-			if (sent > 0)
-			{
-				clients[j]->outbuf.erase(0, sent);
-			}
-			else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
-			{
-				std::cout << "Send error: " << strerror(errno) << std::endl;
-				close(pfds[i].fd);
-				removeClient(i);
-				return true; // removed
-			}
-			break;
+			LOG(NET, INFO) << "Send error on client " << fd << ": " << strerror(errno);
+			++this->connStats.disconnects[DISCONNECT_ERROR];
+			removeClient(fd);
+			close(fd);
+			return true; // removed
 		}
+		break;
+	}
+	// WRITE ilgisi sadece gönderilecek veri varken açık kalır, yoksa loop boşa döner
+	if (client && client->outbuf.empty() == client->isWriteArmed())
+	{
+		bool armed = !client->outbuf.empty();
+		this->reactor->modify(fd, armed ? (Reactor::READ | Reactor::WRITE) : Reactor::READ);
+		client->setWriteArmed(armed);
 	}
 	return false;
 }
 
+// Bu turda outbuf'ı dolan client'lar: önce doğrudan gönder, kalan varsa WRITE ilgisi açılır
+void Server::flushPending()
+{
+	for (size_t i = 0; i < pendingWrites.size(); i++)
+	{
+		int fd = pendingWrites[i];
+		Client *client = findClient(fd);
+		if (!client)
+			continue;
+		client->clearPending();
+		if (client->getSendQExcess())
+		{
+			dropExcessSendQ(*client, client->getSendQExcess());
+			continue;
+		}
+		if (connections[fd].worker < 0)
+		{
+			// WRITE ilgisi açıksa soket dolu; boşalınca reactor haber verir
+			if (!client->isWriteArmed())
+				handleClientPollout(fd);
+			continue;
+		}
+		// worker modunda outbuf soketin sahibi olan worker'a devredilir
+		if (client->outbuf.empty())
+			continue;
+		std::vector<WorkerMessage> &box = outboxes[connections[fd].worker];
+		box.resize(box.size() + 1);
+		box.back().type = WorkerMessage::SEND;
+		box.back().fd = fd;
+		box.back().worker = connections[fd].worker;
+		box.back().count = client->outbuf.messageCount();
+		box.back().sendq = client->getSendQClass();
+		client->outbuf.moveTo(box.back().data);
+	}
+	pendingWrites.clear();
+	for (size_t w = 0; w < outboxes.size(); w++)
+		workers[w]->getInbox().push(outboxes[w]);
+}
+
+void Server::startWorkers(int port)
+{
+	if (this->backend == "uring")
+	{
+		// worker'lar hazırlık tabanlı döngü kullanıyor
+		LOG(CORE, WARN) << "io_uring is not supported with --workers, using epoll/poll";
+		this->backend = "auto";
+	}
+	this->coreInbox = new MessageQueue();
+	this->reactor = Reactor::create(this->backend);
+	this->reactor->add(this->coreInbox->getWakeFd(), Reactor::READ);
+	for (int i = 0; i < this->workerCount; i++)
+		this->workers.push_back(new Worker(i, port, this->backend, this->coreInbox, this->sendq));
+	this->outboxes.resize(this->workerCount);
+	for (size_t i = 0; i < this->workers.size(); i++)
+		this->workers[i]->start();
+	LOG(CORE, INFO) << "IRC Server Has Been Running! (" << this->reactor->name() << ", "
+		<< this->workerCount << " workers)";
+}
+
+void Server::stopWorkers()
+{
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i]->stop();
+}
+
+// mesajı gönderen worker'ın bağlantısı; fd numarası bu arada başka worker'da yeniden açılmış olabilir
+Client *Server::findWorkerClient(const WorkerMessage &msg)
+{
+	Client *client = findClient(msg.fd);
+	if (!client || connections[msg.fd].worker != msg.worker)
+		return NULL;
+	return client;
+}
+
+// worker'lardan gelen bağlantı olayları ve ham veri
+void Server::handleWorkerMessages()
+{
+	std::vector<WorkerMessage> msgs;
+	this->coreInbox->drain(msgs);
+	for (size_t i = 0; i < msgs.size(); i++)
+	{
+		WorkerMessage &msg = msgs[i];
+		if (msg.type == WorkerMessage::OPEN)
+		{
+			Client *cl = addClient(msg.fd, msg.worker);
+			++this->connStats.accepted;
+			std::memcpy(&cl->getAddr(), msg.data.data(), std::min(msg.data.size(), sizeof(cl->getAddr())));
+
+			char ip[INET_ADDRSTRLEN];
+			inet_ntop(AF_INET, &cl->getAddr().sin_addr, ip, sizeof(ip));
+			LOG(NET, INFO) << "New Connection : " << ip << " (worker " << msg.worker << ")";
+		}
+		else if (msg.type == WorkerMessage::DATA)
+		{
+			Client *client = findWorkerClient(msg);
+			if (!client)
+				continue;
+			feedInput(*client, msg.data.data(), msg.data.size());
+		}
+		else if (msg.type == WorkerMessage::CLOSED && findWorkerClient(msg))
+		{
+			LOG(NET, INFO) << "Client " << msg.fd << " disconnected";
+			++this->connStats.disconnects[DISCONNECT_CLOSED];
+			removeClient(msg.fd);
+			// artık bu fd'ye SEND gitmeyecek, worker kapatabilir
+			std::vector<WorkerMessage> &box = outboxes[msg.worker];
+			box.resize(box.size() + 1);
+			box.back().type = WorkerMessage::RELEASE;
+			box.back().fd = msg.fd;
+			box.back().worker = msg.worker;
+		}
+		else if (msg.type == WorkerMessage::EXCESS && findWorkerClient(msg))
+			dropExcessSendQ(*findWorkerClient(msg), msg.count);
+	}
+}
+
+// Kuyruğu limiti aşan client kanallarına QUIT ile duyurulur ve bağlantı kapatılır.
+// Kuyruk zaten atıldı; ERROR satırı sadece soket yer kabul ederse gider.
+void Server::dropExcessSendQ(Client &client, int reason)
+{
+	int fd = client.getFd();
+	SendQClass &cls = this->sendq[client.getSendQClass()];
+	if (reason == SendQClass::MESSAGES)
+		cls.excessMessages++;
+	else
+		cls.excessBytes++;
+	LOG(NET, WARN) << "Excess SendQ: fd " << fd << " (" << cls.name << " class, "
+		<< (reason == SendQClass::MESSAGES ? "message" : "byte") << " limit, "
+		<< cls.excessBytes + cls.excessMessages << " so far)";
+
+	client.resetSendQ(); // handleQuit'in ERROR satırı kuyruğa girebilsin
+	disconnect(client, "Excess SendQ", DISCONNECT_SENDQ);
+}
+
+// Kanallara QUIT ile duyurur, ERROR satırını en iyi çabayla gönderip bağlantıyı kapatır.
+void Server::disconnect(Client &client, const std::string &reason, DisconnectReason cause)
+{
+	int fd = client.getFd();
+	++this->connStats.disconnects[cause];
+	std::vector<std::string> params(1, reason);
+	handleQuit(params, client);
+	std::string error;
+	client.outbuf.moveTo(error);
+
+	int worker = connections[fd].worker;
+	removeClient(fd);
+	if (worker < 0)
+	{
+		send(fd, error.data(), error.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+		close(fd);
+		return;
+	}
+	std::vector<WorkerMessage> &box = outboxes[worker];
+	box.resize(box.size() + 1);
+	box.back().type = WorkerMessage::DISCONNECT;
+	box.back().fd = fd;
+	box.back().worker = worker;
+	box.back().data.swap(error);
+}
+
 
 void Server::start(int port, const char *pass)
 {
@@ -251,57 +631,124 @@ void Server::start(int port, const char *pass)
 
 	struct sockaddr_in hints;
 	std::memset(&hints, 0, sizeof(hints)); // Initialize hints to zero
-	initServer(hints, port);
+	if (this->workerCount > 0)
+		startWorkers(port);
+	else
+		initServer(hints, port);
+	openMetrics();
 
+	std::vector<ReactorEvent> ready;
+	calibrateLag();
+	updateClock();
+	this->timers.start(this->clock.monotonicMs());
+	unsigned long long turnEnd = Clock::cycles();
 	while (this->running)
 	{
-		if (poll(this->pfds, this->num_of_pfd, -1) < 0)
+		int waitMs = this->timers.timeoutMs(this->clock.monotonicMs());
+		int result = this->reactor->wait(ready, waitMs);
+		unsigned long long woke = Clock::cycles(); // bekleme ile iş bu noktada ayrılır
+		updateClock();
+		if (result < 0)
 		{
 			if (!this->running) // Eğer server durduruluyorsa, poll hatasını görmezden gel
 				break;
+			if (errno == EINTR)
+				continue;
 			throw std::exception();
 		}
 
-		// yeni connection olup olmadigini kontrol et.
-		if (this->pfds[0].revents & POLLIN)
+		// sadece hazır olan fd'ler dönüyor, tüm client listesi taranmıyor
+		for (size_t i = 0; i < ready.size(); i++)
 		{
-			Client *cl = new Client;
-			socklen_t len = sizeof(cl->in_soc);
+			int fd = ready[i].fd;
 
-			int client_fd = accept(this->serverFd, (struct sockaddr*)&(cl->in_soc), &len);
-			cl->setFd(client_fd);
-			if (client_fd >= 0)
+			if (this->coreInbox && fd == this->coreInbox->getWakeFd())
 			{
-				setNonBlocking(cl->getFd());
-
-				this->pfds[this->num_of_pfd].fd = cl->getFd();
-				this->pfds[this->num_of_pfd].events = POLLIN | POLLOUT;//pollout durumuna da baktı
-				this->num_of_pfd++;
-				this->clients.push_back(cl);
-				
-				std::string welcome = "Hello World!\n";
-				send(cl->getFd(), welcome.c_str(), welcome.size(), 0);
-
-				char ip[INET_ADDRSTRLEN];
-				inet_ntop(AF_INET, &cl->in_soc.sin_addr, ip, sizeof(ip));
-				std::cout << "New Connection : " << ip << std::endl;
+				handleWorkerMessages();
+				continue;
 			}
-		}
-		
-		// surekli pollfdnin icindeki clientler veri gonderiyor mu onu kontrol et
-		for (int i = 1; i < this->num_of_pfd; i++)
-		{
-			if (this->pfds[i].revents & POLLIN)// girdi durumunda clientleri ayarlıyor
-				handleClient(i);
-			if (this->pfds[i].revents & POLLOUT)// çıktı durumunda clientleri ayarlıyor
+
+			// metrics soketi ve scrape bağlantıları; exporter kapalıyken tek karşılaştırma
+			if (this->metricsFd >= 0 && (fd == this->metricsFd || this->scrapes.count(fd)))
 			{
-				// kullanıcıya not; true döndürdüğü zaman clientın kaldırıldığı anlaşılmalı, buna göre i düzenlenmeli
-				if (handleClientPollout(i))
-					i--;
+				serveMetrics(ready[i]);
+				continue;
 			}
+
+			// yeni connection olup olmadigini kontrol et.
+			if (fd == this->serverFd)
+			{
+				struct sockaddr_in addr;
+				socklen_t len = sizeof(addr);
+
+				int client_fd;
+				if (ready[i].events & Reactor::ACCEPTED)
+				{
+					// io_uring accept'i zaten yaptı
+					client_fd = ready[i].result;
+					getpeername(client_fd, (struct sockaddr*)&addr, &len);
+				}
+				else
+					client_fd = accept(this->serverFd, (struct sockaddr*)&addr, &len);
+				// Client yalnızca accept başarılıysa alınır
+				if (client_fd >= 0)
+				{
+					// io_uring kendi bekler; O_NONBLOCK soketlerde EAGAIN'i bize döndürebilir
+					if (!this->reactor->completionBased())
+						setNonBlocking(client_fd);
+
+					this->reactor->add(client_fd, Reactor::READ);
+					Client *cl = addClient(client_fd);
+					++this->connStats.accepted;
+					cl->getAddr() = addr;
+					
+					std::string welcome = "Hello World!\n";
+					send(cl->getFd(), welcome.c_str(), welcome.size(), 0);
+
+					char ip[INET_ADDRSTRLEN];
+					inet_ntop(AF_INET, &cl->getAddr().sin_addr, ip, sizeof(ip));
+					LOG(NET, INFO) << "New Connection : " << ip;
+				}
+				continue;
+			}
+
+			if (ready[i].events & Reactor::HANGUP)
+			{
+				if (findClient(fd))
+				{
+					LOG(NET, INFO) << "Client " << fd << " disconnected";
+					// io_uring: 0 karşı taraf kapattı, negatif recv/send hatası
+					++this->connStats.disconnects[ready[i].result < 0 ? DISCONNECT_ERROR : DISCONNECT_CLOSED];
+					removeClient(fd);
+					close(fd);
+				}
+				continue;
+			}
+			if (ready[i].events & Reactor::DATA)// io_uring veriyi zaten okudu
+			{
+				Client *client = findClient(fd);
+				if (client)
+				{
+					feedInput(*client, ready[i].data, ready[i].result);
+				}
+			}
+			if (ready[i].events & (Reactor::READ | Reactor::ERROR))// girdi durumunda clientleri ayarlıyor
+				handleClient(fd);
+			if (ready[i].events & Reactor::WRITE)// çıktı durumunda clientleri ayarlıyor
+				handleClientPollout(fd);
 		}
+		runTimers();
+		flushPending();
+		unsigned long long done = Clock::cycles();
+		endTurn(done - woke, woke - turnEnd, ready.size());
+		turnEnd = done;
 	}
-	close(this->serverFd);
+	LOG(CORE, INFO) << "Stopping server gracefully...";
+	stopWorkers();
+	closeMetrics();
+	if (this->serverFd > 0)
+		close(this->serverFd);
+	this->serverFd = 0;
 }
 
 
@@ -315,11 +762,11 @@ void Server::handleAway(const std::vector<std::string>& params, Client &client)
         {
             client.setAway(false);
             client.setAwayMessage("");
-            enqueue(client.outbuf, ":server 305 " + client.getNick() + " :You are no longer marked as being away\r\n");
+            enqueue(client, ":server 305 " + client.getNick() + " :You are no longer marked as being away\r\n");
         }
         else
         {
-            enqueue(client.outbuf, ":server 306 " + client.getNick() + " :You have been marked as being away\r\n");
+            enqueue(client, ":server 306 " + client.getNick() + " :You have been marked as being away\r\n");
         }
     }
     else
@@ -332,6 +779,6 @@ void Server::handleAway(const std::vector<std::string>& params, Client &client)
         }
         client.setAway(true);
         client.setAwayMessage(message);
-        enqueue(client.outbuf, ":server 306 " + client.getNick() + " :You have been marked as being away\r\n");
+        enqueue(client, ":server 306 " + client.getNick() + " :You have been marked as being away\r\n");
     }
 }
\ No newline at end of file
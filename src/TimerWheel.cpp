@@ -0,0 +1,166 @@
+#include "../include/TimerWheel.hpp"
+#include <climits>
+
+#define SLOT_BITS 6
+#define SLOT_MASK (TIMER_SLOTS - 1)
+#define EXPIRED_LEVEL 0xff // expired listesindeki timer'ın level işareti
+
+TimerWheel::TimerWheel() : expired(NULL), current(0), count(0)
+{
+	for (int l = 0; l < TIMER_LEVELS; ++l)
+	{
+		this->occupied[l] = 0;
+		for (int s = 0; s < TIMER_SLOTS; ++s)
+			this->slots[l][s] = NULL;
+	}
+}
+
+// boş çarkta şimdiki zamana atlanır; aradaki tick'ler tek tek yürünmez
+void TimerWheel::start(unsigned long long nowMs)
+{
+	this->current = nowMs / TIMER_TICK_MS;
+}
+
+void TimerWheel::link(Timer *&head, Timer &timer)
+{
+	timer.next = head;
+	if (head)
+		head->pprev = &timer.next;
+	head = &timer;
+	timer.pprev = &head;
+}
+
+void TimerWheel::unlink(Timer &timer)
+{
+	*timer.pprev = timer.next;
+	if (timer.next)
+		timer.next->pprev = timer.pprev;
+	if (timer.level != EXPIRED_LEVEL && !this->slots[timer.level][timer.slot])
+		this->occupied[timer.level] &= ~(1ULL << timer.slot);
+	timer.next = NULL;
+	timer.pprev = NULL;
+}
+
+// kalan süreye göre seviye: L seviyesindeki bir slot 64^L tick kapsar
+void TimerWheel::place(Timer &timer)
+{
+	unsigned long long delta = timer.expires - this->current;
+	int level = 0;
+	while (level < TIMER_LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+		++level;
+	unsigned long long max = (1ULL << (SLOT_BITS * TIMER_LEVELS)) - 1;
+	if (delta > max)
+		timer.expires = this->current + max; // 19 günden uzağı sınırda bekler
+	timer.level = level;
+	timer.slot = (timer.expires >> (SLOT_BITS * level)) & SLOT_MASK;
+	link(this->slots[level][timer.slot], timer);
+	this->occupied[level] |= 1ULL << timer.slot;
+}
+
+void TimerWheel::schedule(Timer &timer, unsigned long long atMs)
+{
+	if (timer.pending())
+		cancel(timer);
+	// tick'in sonuna yuvarlanır: zamanından erken hiç çalmaz
+	timer.expires = (atMs + TIMER_TICK_MS - 1) / TIMER_TICK_MS;
+	if (timer.expires <= this->current)
+		timer.expires = this->current + 1;
+	place(timer);
+	++this->count;
+}
+
+void TimerWheel::cancel(Timer &timer)
+{
+	if (!timer.pending())
+		return;
+	unlink(timer);
+	--this->count;
+}
+
+// üst seviyedeki slot, zamanı gelince alt seviyelere dağıtılır
+void TimerWheel::cascade(int level)
+{
+	int slot = (this->current >> (SLOT_BITS * level)) & SLOT_MASK;
+	Timer *list = this->slots[level][slot];
+	this->slots[level][slot] = NULL;
+	this->occupied[level] &= ~(1ULL << slot);
+	while (list)
+	{
+		Timer *timer = list;
+		list = list->next;
+		timer->next = NULL;
+		timer->pprev = NULL;
+		place(*timer);
+	}
+}
+
+void TimerWheel::advance(unsigned long long nowMs)
+{
+	unsigned long long target = nowMs / TIMER_TICK_MS;
+	if (this->count == 0)
+	{
+		if (target > this->current)
+			this->current = target;
+		return;
+	}
+	while (this->current < target)
+	{
+		++this->current;
+		for (int level = 1; level < TIMER_LEVELS; ++level)
+		{
+			// alt seviye başa döndüyse bu seviyenin sıradaki slotu iner
+			if (this->current & ((1ULL << (SLOT_BITS * level)) - 1))
+				break;
+			cascade(level);
+		}
+		int slot = this->current & SLOT_MASK;
+		while (Timer *timer = this->slots[0][slot])
+		{
+			unlink(*timer);
+			timer->level = EXPIRED_LEVEL;
+			link(this->expired, *timer);
+		}
+	}
+}
+
+Timer *TimerWheel::nextExpired()
+{
+	Timer *timer = this->expired;
+	if (!timer)
+		return NULL;
+	unlink(*timer);
+	--this->count;
+	return timer;
+}
+
+// seviye başına sıradaki dolu slot bitmap'ten bulunur; üst seviyede bu slotun
+// alta ineceği an döner (timer'ın kendisi daha geç olabilir, o zaman yeniden hesaplanır)
+int TimerWheel::timeoutMs(unsigned long long nowMs) const
+{
+	if (this->expired)
+		return 0;
+	if (this->count == 0)
+		return -1;
+	unsigned long long next = ~0ULL;
+	for (int level = 0; level < TIMER_LEVELS; ++level)
+	{
+		if (!this->occupied[level])
+			continue;
+		int shift = SLOT_BITS * level;
+		int from = ((this->current >> shift) + 1) & SLOT_MASK;
+		unsigned long long bits = this->occupied[level];
+		unsigned long long rotated = from ? (bits >> from) | (bits << (TIMER_SLOTS - from)) : bits;
+		unsigned long long ahead = __builtin_ctzll(rotated) + 1; // 1..64 slot sonra
+		unsigned long long tick = ((this->current >> shift) + ahead) << shift;
+		if (tick < next)
+			next = tick;
+	}
+	unsigned long long atMs = next * TIMER_TICK_MS;
+	if (atMs <= nowMs)
+		return 0;
+	if (atMs - nowMs > INT_MAX)
+		return INT_MAX;
+	return atMs - nowMs;
+}
+
+size_t TimerWheel::size() const { return this->count; }
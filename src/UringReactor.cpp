@@ -0,0 +1,435 @@
+#include "../include/Reactor.hpp"
+
+#ifdef HAVE_IO_URING
+
+# include <stdexcept>
+# include <cerrno>
+# include <cstring>
+# include <algorithm>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <sys/socket.h>
+
+# define URING_ENTRIES 4096
+# define URING_CQ_ENTRIES 16384
+# define URING_BUF_COUNT 1024 // power of two
+# define URING_BUF_SIZE 4096
+
+// user_data: | gen (32) | op (8) | fd (24) |
+enum
+{
+	OP_ACCEPT = 1,
+	OP_RECV,
+	OP_SEND,
+	OP_CANCEL
+};
+
+static uint64_t pack(int op, int fd, uint32_t gen)
+{
+	return ((uint64_t)gen << 32) | ((uint64_t)op << 24) | ((uint64_t)fd & 0xffffff);
+}
+
+static ReactorEvent makeEvent(int fd, unsigned int events, int result, const char *data)
+{
+	ReactorEvent ev;
+	ev.fd = fd;
+	ev.events = events;
+	ev.result = result;
+	ev.data = data;
+	return ev;
+}
+
+UringReactor::UringReactor()
+	: ringFd(-1), features(0), sqRing(MAP_FAILED), cqRing(MAP_FAILED), sqRingSize(0), cqRingSize(0),
+	  sqes((struct io_uring_sqe *)MAP_FAILED), sqesSize(0), sqLocalTail(0), sqEntries(0),
+	  bufRing((struct io_uring_buf_ring *)MAP_FAILED), bufBase((char *)MAP_FAILED),
+	  bufCount(URING_BUF_COUNT), bufSize(URING_BUF_SIZE)
+{
+	try
+	{
+		setup();
+	}
+	catch (...)
+	{
+		teardown();
+		throw;
+	}
+}
+
+UringReactor::~UringReactor()
+{
+	teardown();
+}
+
+void UringReactor::setup()
+{
+	struct io_uring_params p;
+	std::memset(&p, 0, sizeof(p));
+	p.flags = IORING_SETUP_CQSIZE;
+	p.cq_entries = URING_CQ_ENTRIES;
+	this->ringFd = syscall(__NR_io_uring_setup, URING_ENTRIES, &p);
+	if (this->ringFd < 0)
+		throw(std::runtime_error(std::string("io_uring_setup: ") + strerror(errno)));
+	this->features = p.features;
+	if (!(this->features & IORING_FEAT_EXT_ARG) || !(this->features & IORING_FEAT_NODROP))
+		throw(std::runtime_error("kernel io_uring is too old"));
+
+	this->sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	this->cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	bool single = this->features & IORING_FEAT_SINGLE_MMAP;
+	if (single)
+		this->sqRingSize = this->cqRingSize = std::max(this->sqRingSize, this->cqRingSize);
+
+	this->sqRing = mmap(NULL, this->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		this->ringFd, IORING_OFF_SQ_RING);
+	if (this->sqRing == MAP_FAILED)
+		throw(std::runtime_error("io_uring sq ring mmap failed"));
+	if (single)
+		this->cqRing = this->sqRing;
+	else
+	{
+		this->cqRing = mmap(NULL, this->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			this->ringFd, IORING_OFF_CQ_RING);
+		if (this->cqRing == MAP_FAILED)
+			throw(std::runtime_error("io_uring cq ring mmap failed"));
+	}
+	this->sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+	this->sqes = (struct io_uring_sqe *)mmap(NULL, this->sqesSize, PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE, this->ringFd, IORING_OFF_SQES);
+	if (this->sqes == MAP_FAILED)
+		throw(std::runtime_error("io_uring sqe mmap failed"));
+
+	char *sq = (char *)this->sqRing;
+	char *cq = (char *)this->cqRing;
+	this->sqHead = (unsigned *)(sq + p.sq_off.head);
+	this->sqTail = (unsigned *)(sq + p.sq_off.tail);
+	this->sqMask = (unsigned *)(sq + p.sq_off.ring_mask);
+	this->sqArray = (unsigned *)(sq + p.sq_off.array);
+	this->cqHead = (unsigned *)(cq + p.cq_off.head);
+	this->cqTail = (unsigned *)(cq + p.cq_off.tail);
+	this->cqMask = (unsigned *)(cq + p.cq_off.ring_mask);
+	this->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+	this->sqEntries = p.sq_entries;
+	this->sqLocalTail = *this->sqTail;
+
+	// provided buffer ring: multishot recv picks a buffer per completion
+	this->bufRing = (struct io_uring_buf_ring *)mmap(NULL, this->bufCount * sizeof(struct io_uring_buf),
+		PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	this->bufBase = (char *)mmap(NULL, (size_t)this->bufCount * this->bufSize,
+		PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (this->bufRing == MAP_FAILED || this->bufBase == MAP_FAILED)
+		throw(std::runtime_error("io_uring buffer mmap failed"));
+
+	struct io_uring_buf_reg reg;
+	std::memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = (uint64_t)(uintptr_t)this->bufRing;
+	reg.ring_entries = this->bufCount;
+	reg.bgid = 0;
+	if (syscall(__NR_io_uring_register, this->ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+		throw(std::runtime_error(std::string("buffer ring registration: ") + strerror(errno)));
+
+	for (unsigned i = 0; i < this->bufCount; ++i)
+		this->recycle.push_back(i);
+	recycleBuffers();
+}
+
+void UringReactor::teardown()
+{
+	if (this->bufBase != MAP_FAILED)
+		munmap(this->bufBase, (size_t)this->bufCount * this->bufSize);
+	if (this->bufRing != MAP_FAILED)
+		munmap(this->bufRing, this->bufCount * sizeof(struct io_uring_buf));
+	if (this->sqes != MAP_FAILED)
+		munmap(this->sqes, this->sqesSize);
+	if (this->cqRing != MAP_FAILED && this->cqRing != this->sqRing)
+		munmap(this->cqRing, this->cqRingSize);
+	if (this->sqRing != MAP_FAILED)
+		munmap(this->sqRing, this->sqRingSize);
+	if (this->ringFd >= 0)
+		close(this->ringFd);
+	this->bufBase = (char *)MAP_FAILED;
+	this->bufRing = (struct io_uring_buf_ring *)MAP_FAILED;
+	this->sqes = (struct io_uring_sqe *)MAP_FAILED;
+	this->cqRing = this->sqRing = MAP_FAILED;
+	this->ringFd = -1;
+}
+
+const char *UringReactor::name() const { return "io_uring"; }
+
+bool UringReactor::completionBased() const { return true; }
+
+UringReactor::Slot &UringReactor::slot(int fd)
+{
+	if ((size_t)fd >= slots.size())
+	{
+		Slot empty;
+		empty.gen = 0;
+		empty.listener = false;
+		empty.rearm = false;
+		empty.sending = false;
+		empty.offset = 0;
+		slots.resize(std::max((size_t)fd + 1, slots.size() * 2), empty);
+	}
+	return slots[fd];
+}
+
+struct io_uring_sqe *UringReactor::getSqe()
+{
+	// SQ doluysa bekleyenleri beklemeden gönder
+	if (this->sqLocalTail - __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE) >= this->sqEntries)
+		enter(0, 0);
+	unsigned idx = this->sqLocalTail & *this->sqMask;
+	struct io_uring_sqe *sqe = &this->sqes[idx];
+	std::memset(sqe, 0, sizeof(*sqe));
+	this->sqArray[idx] = idx;
+	++this->sqLocalTail;
+	return sqe;
+}
+
+// Publishes queued SQEs and submits them in the same syscall that waits for completions.
+int UringReactor::enter(unsigned minComplete, int timeoutMs)
+{
+	__atomic_store_n(this->sqTail, this->sqLocalTail, __ATOMIC_RELEASE);
+	unsigned toSubmit = this->sqLocalTail - __atomic_load_n(this->sqHead, __ATOMIC_ACQUIRE);
+	unsigned flags = minComplete ? IORING_ENTER_GETEVENTS : 0;
+	if (minComplete && timeoutMs >= 0)
+	{
+		struct __kernel_timespec ts;
+		ts.tv_sec = timeoutMs / 1000;
+		ts.tv_nsec = (long long)(timeoutMs % 1000) * 1000000;
+		struct io_uring_getevents_arg arg;
+		std::memset(&arg, 0, sizeof(arg));
+		arg.ts = (uint64_t)(uintptr_t)&ts;
+		return syscall(__NR_io_uring_enter, this->ringFd, toSubmit, minComplete,
+			flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+	}
+	if (!toSubmit && !minComplete)
+		return 0;
+	return syscall(__NR_io_uring_enter, this->ringFd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+void UringReactor::armAccept(int fd)
+{
+	struct io_uring_sqe *sqe = getSqe();
+	sqe->opcode = IORING_OP_ACCEPT;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+	sqe->user_data = pack(OP_ACCEPT, fd, slot(fd).gen);
+}
+
+void UringReactor::armRecv(int fd)
+{
+	struct io_uring_sqe *sqe = getSqe();
+	sqe->opcode = IORING_OP_RECV;
+	sqe->fd = fd;
+	sqe->ioprio = IORING_RECV_MULTISHOT;
+	sqe->flags = IOSQE_BUFFER_SELECT;
+	sqe->buf_group = 0;
+	sqe->user_data = pack(OP_RECV, fd, slot(fd).gen);
+}
+
+void UringReactor::armSend(int fd)
+{
+	Slot &s = slot(fd);
+	struct io_uring_sqe *sqe = getSqe();
+	sqe->opcode = IORING_OP_SEND;
+	sqe->fd = fd;
+	sqe->addr = (uint64_t)(uintptr_t)(s.inflight.data() + s.offset);
+	sqe->len = s.inflight.size() - s.offset;
+	sqe->msg_flags = MSG_NOSIGNAL;
+	sqe->user_data = pack(OP_SEND, fd, s.gen);
+}
+
+void UringReactor::recycleBuffers()
+{
+	if (recycle.empty())
+		return;
+	unsigned short tail = this->bufRing->tail;
+	unsigned mask = this->bufCount - 1;
+	// C++'ta __DECLARE_FLEX_ARRAY bufs'u 8 byte kaydırıyor, ring'i doğrudan indeksle
+	struct io_uring_buf *bufs = (struct io_uring_buf *)(void *)this->bufRing;
+	for (size_t i = 0; i < recycle.size(); ++i)
+	{
+		// bufs[0].resv ring tail'i ile çakışır, o alana dokunma
+		struct io_uring_buf *b = &bufs[(tail + i) & mask];
+		b->addr = (uint64_t)(uintptr_t)(this->bufBase + (size_t)recycle[i] * this->bufSize);
+		b->len = this->bufSize;
+		b->bid = recycle[i];
+	}
+	__atomic_store_n(&this->bufRing->tail, (unsigned short)(tail + recycle.size()), __ATOMIC_RELEASE);
+	recycle.clear();
+}
+
+void UringReactor::releaseOrphan(uint64_t userData)
+{
+	for (size_t i = 0; i < orphans.size(); ++i)
+	{
+		if (orphans[i].first == userData)
+		{
+			orphans[i].first = orphans.back().first;
+			orphans[i].second.swap(orphans.back().second);
+			orphans.pop_back();
+			return;
+		}
+	}
+}
+
+void UringReactor::add(int fd, unsigned int events)
+{
+	(void)events; // recv hep açık, yazma submitSend ile
+	Slot &s = slot(fd);
+	s.listener = false;
+	s.rearm = false;
+	s.sending = false;
+	s.offset = 0;
+	armRecv(fd);
+}
+
+void UringReactor::addListener(int fd)
+{
+	slot(fd).listener = true;
+	armAccept(fd);
+}
+
+void UringReactor::modify(int fd, unsigned int events)
+{
+	(void)fd;
+	(void)events;
+}
+
+void UringReactor::remove(int fd)
+{
+	if ((size_t)fd >= slots.size())
+		return;
+	Slot &s = slots[fd];
+	struct io_uring_sqe *sqe = getSqe();
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->addr = pack(s.listener ? OP_ACCEPT : OP_RECV, fd, s.gen);
+	sqe->user_data = pack(OP_CANCEL, fd, s.gen);
+	// kernel hâlâ okuyor olabilir; tamamlanana kadar buffer'ı sakla
+	if (s.sending)
+	{
+		orphans.push_back(std::make_pair(pack(OP_SEND, fd, s.gen), std::string()));
+		orphans.back().second.swap(s.inflight);
+	}
+	s.inflight.clear();
+	s.offset = 0;
+	s.sending = false;
+	s.rearm = false;
+	s.listener = false;
+	++s.gen; // eski generation'a ait completion'lar yok sayılır
+}
+
+bool UringReactor::submitSend(int fd, OutQueue &queue)
+{
+	Slot &s = slot(fd);
+	if (s.sending || queue.empty())
+		return false;
+	// SQE tamamlanana kadar byte'lar sabit kalmalı, kuyruk burada düzleştirilir
+	queue.moveTo(s.inflight);
+	s.offset = 0;
+	s.sending = true;
+	armSend(fd);
+	return true;
+}
+
+int UringReactor::wait(std::vector<ReactorEvent> &ready, int timeoutMs)
+{
+	ready.clear();
+	// önceki turun DATA buffer'ları artık serbest
+	recycleBuffers();
+	for (size_t i = 0; i < rearmFds.size(); ++i)
+	{
+		int fd = rearmFds[i];
+		if (slots[fd].rearm)
+		{
+			slots[fd].rearm = false;
+			armRecv(fd);
+		}
+	}
+	rearmFds.clear();
+
+	unsigned head = *this->cqHead;
+	bool pending = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE) != head;
+	if (enter((pending || timeoutMs == 0) ? 0 : 1, timeoutMs) < 0 && errno != ETIME && errno != EBUSY)
+		return -1;
+
+	unsigned tail = __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE);
+	for (; head != tail; ++head)
+	{
+		struct io_uring_cqe *cqe = &this->cqes[head & *this->cqMask];
+		uint64_t ud = cqe->user_data;
+		int op = (ud >> 24) & 0xff;
+		int fd = ud & 0xffffff;
+		uint32_t gen = ud >> 32;
+		int res = cqe->res;
+		unsigned flags = cqe->flags;
+		const char *data = NULL;
+		if (flags & IORING_CQE_F_BUFFER)
+		{
+			unsigned short bid = flags >> IORING_CQE_BUFFER_SHIFT;
+			data = this->bufBase + (size_t)bid * this->bufSize;
+			recycle.push_back(bid);
+		}
+		if (op == OP_CANCEL)
+			continue;
+		if ((size_t)fd >= slots.size() || slots[fd].gen != gen)
+		{
+			if (op == OP_SEND)
+				releaseOrphan(ud);
+			continue;
+		}
+		Slot &s = slots[fd];
+		bool more = flags & IORING_CQE_F_MORE;
+		if (op == OP_ACCEPT)
+		{
+			if (res >= 0)
+				ready.push_back(makeEvent(fd, ACCEPTED, res, NULL));
+			if (!more)
+				armAccept(fd);
+		}
+		else if (op == OP_RECV)
+		{
+			if (res > 0 && data)
+				ready.push_back(makeEvent(fd, DATA, res, data));
+			if (!more)
+			{
+				// buffer bitti (ENOBUFS) ya da kernel multishot'ı kesti: sonraki turda yeniden kur
+				if (res > 0 || res == -ENOBUFS)
+				{
+					s.rearm = true;
+					rearmFds.push_back(fd);
+				}
+				else
+					ready.push_back(makeEvent(fd, HANGUP, res, NULL));
+			}
+		}
+		else if (op == OP_SEND)
+		{
+			if (res < 0)
+			{
+				s.sending = false;
+				s.inflight.clear();
+				ready.push_back(makeEvent(fd, HANGUP, res, NULL));
+			}
+			else
+			{
+				s.offset += res;
+				if (s.offset < s.inflight.size())
+					armSend(fd);
+				else
+				{
+					s.sending = false;
+					s.inflight.clear();
+					s.offset = 0;
+					ready.push_back(makeEvent(fd, WRITE, 0, NULL));
+				}
+			}
+		}
+	}
+	__atomic_store_n(this->cqHead, head, __ATOMIC_RELEASE);
+	return ready.size();
+}
+
+#endif
@@ -0,0 +1,346 @@
+#include "../include/Server.hpp"
+#include <signal.h>
+
+// ---------- MessageQueue ----------
+
+MessageQueue::MessageQueue()
+{
+	pthread_mutex_init(&this->lock, NULL);
+	if (pipe(this->wakeFds) == -1)
+		throw(std::runtime_error("Failed to create wake pipe."));
+	setNonBlocking(this->wakeFds[0]);
+	setNonBlocking(this->wakeFds[1]);
+}
+
+MessageQueue::~MessageQueue()
+{
+	close(this->wakeFds[0]);
+	close(this->wakeFds[1]);
+	pthread_mutex_destroy(&this->lock);
+}
+
+int MessageQueue::getWakeFd() const
+{
+	return this->wakeFds[0];
+}
+
+void MessageQueue::push(std::vector<WorkerMessage> &batch)
+{
+	if (batch.empty())
+		return;
+	pthread_mutex_lock(&this->lock);
+	bool wasEmpty = items.empty();
+	if (wasEmpty)
+		items.swap(batch);
+	else
+	{
+		// stringleri kopyalamadan taşı
+		size_t base = items.size();
+		items.resize(base + batch.size());
+		for (size_t i = 0; i < batch.size(); ++i)
+		{
+			items[base + i].type = batch[i].type;
+			items[base + i].fd = batch[i].fd;
+			items[base + i].worker = batch[i].worker;
+			items[base + i].count = batch[i].count;
+			items[base + i].sendq = batch[i].sendq;
+			items[base + i].data.swap(batch[i].data);
+		}
+	}
+	pthread_mutex_unlock(&this->lock);
+	batch.clear();
+	if (wasEmpty)
+	{
+		char c = 1;
+		ssize_t r = write(this->wakeFds[1], &c, 1); // pipe doluysa tüketici zaten uyanacak
+		(void)r;
+	}
+}
+
+void MessageQueue::drain(std::vector<WorkerMessage> &out)
+{
+	// önce pipe'ı boşalt, sonra kuyruğu al; tersi uyandırma kaybettirir
+	char buf[64];
+	while (read(this->wakeFds[0], buf, sizeof(buf)) > 0)
+		;
+	out.clear();
+	pthread_mutex_lock(&this->lock);
+	out.swap(items);
+	pthread_mutex_unlock(&this->lock);
+}
+
+// ---------- Worker ----------
+
+Worker::Worker(int _id, int port, const std::string &backend, MessageQueue *_coreInbox,
+	const SendQClass *_sendq)
+	: id(_id), listenFd(-1), reactor(NULL), running(false), coreInbox(_coreInbox), sendq(_sendq)
+{
+	struct sockaddr_in addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = INADDR_ANY;
+
+	this->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+	if (this->listenFd == -1)
+		throw(std::runtime_error("Worker socket error."));
+
+	int yes = 1;
+	if (setsockopt(this->listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) == -1)
+		throw(std::runtime_error("Setsockopt error."));
+#ifdef SO_REUSEPORT
+	// her worker aynı porta kendi soketiyle bağlanır, kernel bağlantıları dağıtır
+	if (setsockopt(this->listenFd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) == -1)
+		throw(std::runtime_error("SO_REUSEPORT is not supported."));
+#endif
+	if (bind(this->listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		throw(std::runtime_error("Error while binding worker socket."));
+	if (listen(this->listenFd, BACKLOG) < 0)
+		throw(std::runtime_error("Error while listening worker socket."));
+	setNonBlocking(this->listenFd);
+
+	this->reactor = Reactor::create(backend);
+	this->reactor->add(this->listenFd, Reactor::READ);
+	this->reactor->add(this->inbox.getWakeFd(), Reactor::READ);
+}
+
+Worker::~Worker()
+{
+	for (size_t fd = 0; fd < conns.size(); ++fd)
+	{
+		if (conns[fd] && conns[fd]->open)
+			close(fd);
+		delete conns[fd];
+	}
+	if (this->listenFd >= 0)
+		close(this->listenFd);
+	delete this->reactor;
+}
+
+MessageQueue &Worker::getInbox()
+{
+	return this->inbox;
+}
+
+void Worker::start()
+{
+	// sinyaller sadece ana thread'e gelsin
+	sigset_t all, old;
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	this->running = true;
+	int err = pthread_create(&this->thread, NULL, &Worker::run, this);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (err != 0)
+	{
+		this->running = false;
+		throw(std::runtime_error("Failed to start worker thread."));
+	}
+}
+
+void Worker::stop()
+{
+	if (!this->running)
+		return;
+	this->running = false;
+	std::vector<WorkerMessage> wake(1);
+	wake[0].type = WorkerMessage::RELEASE;
+	wake[0].fd = -1;
+	wake[0].worker = this->id;
+	wake[0].count = 0;
+	wake[0].sendq = 0;
+	this->inbox.push(wake);
+	pthread_join(this->thread, NULL);
+}
+
+void *Worker::run(void *arg)
+{
+	static_cast<Worker *>(arg)->loop();
+	return NULL;
+}
+
+void Worker::post(int type, int fd, const char *data, size_t len)
+{
+	outgoing.resize(outgoing.size() + 1);
+	WorkerMessage &msg = outgoing.back();
+	msg.type = type;
+	msg.fd = fd;
+	msg.worker = this->id;
+	msg.count = 0;
+	msg.sendq = 0;
+	msg.data.assign(data, len);
+}
+
+void Worker::loop()
+{
+	std::vector<ReactorEvent> ready;
+	while (this->running)
+	{
+		if (this->reactor->wait(ready, -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		for (size_t i = 0; i < ready.size(); ++i)
+		{
+			int fd = ready[i].fd;
+			if (fd == this->listenFd)
+				acceptClients();
+			else if (fd == this->inbox.getWakeFd())
+				handleInbox();
+			else
+			{
+				if (ready[i].events & (Reactor::READ | Reactor::ERROR))
+					readClient(fd);
+				if (ready[i].events & Reactor::WRITE)
+					flushClient(fd);
+			}
+		}
+		// bu turda okunan her şey core'a tek seferde gider
+		this->coreInbox->push(outgoing);
+	}
+	SharedMessage::releaseSpares(); // thread'e özel liste thread'le birlikte gider
+}
+
+void Worker::acceptClients()
+{
+	while (true)
+	{
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+		int fd = accept(this->listenFd, (struct sockaddr *)&addr, &len);
+		if (fd < 0)
+			return;
+		setNonBlocking(fd);
+		if ((size_t)fd >= conns.size())
+			conns.resize(std::max((size_t)fd + 1, conns.size() * 2), NULL);
+		if (!conns[fd])
+			conns[fd] = new Conn();
+		conns[fd]->open = true;
+		conns[fd]->dead = false;
+		conns[fd]->armed = false;
+		conns[fd]->excess = false;
+		conns[fd]->outbuf.clear();
+		this->reactor->add(fd, Reactor::READ);
+
+		std::string welcome = "Hello World!\n";
+		send(fd, welcome.c_str(), welcome.size(), 0);
+		post(WorkerMessage::OPEN, fd, (const char *)&addr, sizeof(addr));
+	}
+}
+
+void Worker::readClient(int fd)
+{
+	if ((size_t)fd >= conns.size() || !conns[fd] || !conns[fd]->open || conns[fd]->dead)
+		return;
+	// EAGAIN'e kadar oku ama tek client turu READ_BUDGET ile sınırlı; hepsi tek DATA olur
+	char buffer[INPUT_RING_SIZE];
+	size_t total = 0;
+	ssize_t bytes = 0;
+	while (total < READ_BUDGET)
+	{
+		bytes = recv(fd, buffer, sizeof(buffer), 0);
+		if (bytes <= 0)
+			break;
+		if (total == 0)
+			post(WorkerMessage::DATA, fd, buffer, bytes);
+		else
+			outgoing.back().data.append(buffer, bytes);
+		total += bytes;
+	}
+	if (bytes > 0 || total > 0 || (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)))
+		return;
+	// fd, core RELEASE gönderene kadar açık kalır; böylece numarası yeniden kullanılamaz
+	this->reactor->remove(fd);
+	conns[fd]->dead = true;
+	conns[fd]->outbuf.clear();
+	post(WorkerMessage::CLOSED, fd, NULL, 0);
+}
+
+void Worker::flushClient(int fd)
+{
+	Conn &conn = *conns[fd];
+	if (!conn.open || conn.dead)
+		return;
+	while (!conn.outbuf.empty())
+	{
+		size_t offered;
+		ssize_t sent = conn.outbuf.writeTo(fd, offered);
+		if (sent > 0 && (size_t)sent == offered)
+			continue;
+		if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			this->reactor->remove(fd);
+			conn.dead = true;
+			conn.outbuf.clear();
+			post(WorkerMessage::CLOSED, fd, NULL, 0);
+			return;
+		}
+		break;
+	}
+	bool armed = !conn.outbuf.empty();
+	if (armed != conn.armed)
+	{
+		this->reactor->modify(fd, armed ? (Reactor::READ | Reactor::WRITE) : Reactor::READ);
+		conn.armed = armed;
+	}
+}
+
+// kuyruk sınıf limitini aşarsa atılır; QUIT yayını ve kapatma core'dan gelir
+bool Worker::checkSendQ(int fd, int cls)
+{
+	Conn &conn = *conns[fd];
+	int reason = SendQClass::NONE;
+	if (conn.outbuf.size() > this->sendq[cls].maxBytes)
+		reason = SendQClass::BYTES;
+	else if (conn.outbuf.messageCount() > this->sendq[cls].maxMessages)
+		reason = SendQClass::MESSAGES;
+	else
+		return false;
+	conn.outbuf.clear();
+	conn.excess = true;
+	post(WorkerMessage::EXCESS, fd, NULL, 0);
+	outgoing.back().count = reason;
+	return true;
+}
+
+void Worker::closeClient(int fd)
+{
+	if (!conns[fd]->dead)
+		this->reactor->remove(fd);
+	conns[fd]->open = false;
+	conns[fd]->dead = false;
+	conns[fd]->outbuf.clear();
+	// bu fd için sıradaki DATA/CLOSED/EXCESS, numara başka bir worker'a geçmeden core'a gider
+	this->coreInbox->push(outgoing);
+	close(fd);
+}
+
+void Worker::handleInbox()
+{
+	std::vector<WorkerMessage> msgs;
+	this->inbox.drain(msgs);
+	for (size_t i = 0; i < msgs.size(); ++i)
+	{
+		int fd = msgs[i].fd;
+		if (fd < 0 || (size_t)fd >= conns.size() || !conns[fd] || !conns[fd]->open)
+			continue;
+		if (msgs[i].type == WorkerMessage::SEND)
+		{
+			if (conns[fd]->dead || conns[fd]->excess)
+				continue;
+			conns[fd]->outbuf.adopt(msgs[i].data, msgs[i].count);
+			if (!checkSendQ(fd, msgs[i].sendq) && !conns[fd]->armed) // soket doluysa WRITE olayını bekle
+				flushClient(fd);
+		}
+		else if (msgs[i].type == WorkerMessage::DISCONNECT)
+		{
+			if (!conns[fd]->dead && !msgs[i].data.empty())
+				send(fd, msgs[i].data.data(), msgs[i].data.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+			closeClient(fd);
+		}
+		else if (msgs[i].type == WorkerMessage::RELEASE && conns[fd]->dead)
+			closeClient(fd);
+	}
+}
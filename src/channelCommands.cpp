@@ -2,26 +2,21 @@
 
 void Server::handleMode(const std::vector<std::string>& params, Client &client)
 {
-	if (params.empty())
-    {
-        enqueue(client.outbuf, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
-        return ;
-    }
-
 	std::string target = params[0];
 	Channel* targetChannel = NULL;
 	if (target[0] == '#' || target[0] == '&')
 	{
-		std::map<std::string, Channel*>::iterator channelIt = this->channels.find(target);
+		ChannelMap::iterator channelIt = this->channels.find(target);
 		if (channelIt == this->channels.end())
 		{
-			enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + target + " :No such channel\r\n");
+			enqueue(client, ":server 403 " + client.getNick() + " " + target + " :No such channel\r\n");
 			return ;
 		}
 		targetChannel = channelIt->second;
+		target = targetChannel->getName();
 		if (!targetChannel->isOperator(&client) && params.size() > 1)
 		{
-			enqueue(client.outbuf, ":server 482 " + client.getNick() + " " + target + " :You're not channel operator\r\n");
+			enqueue(client, ":server 482 " + client.getNick() + " " + target + " :You're not channel operator\r\n");
 			return ;
 		}
 		else
@@ -34,7 +29,7 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 				if (targetChannel->hasKey()) modeList += "k";
 				if (targetChannel->isTopicRestricted()) modeList += "t";
 				if (targetChannel->getUserLimit() > 0) modeList += "l";
-				enqueue(client.outbuf, ":server 324 " + client.getNick() + " " + target + " " + modeList + "\r\n");
+				enqueue(client, ":server 324 " + client.getNick() + " " + target + " " + modeList + "\r\n");
 				return ;
 			}
 
@@ -63,7 +58,7 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 							{
 								if (params.size() < 3)
 								{
-									enqueue(client.outbuf, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
+									enqueue(client, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
 									return ;
 								}
 								targetChannel->setKey(params[2]);
@@ -77,37 +72,22 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 							targetChannel->setTopicRestricted(adding);
 							break;
 						case 'o':
-							// +o/-o operatör modunu client parametresiyle birlikte handle et
+						case 'v':
+							// +o/-o ve +v/-v üye modunu client parametresiyle birlikte handle et
 							if (params.size() < 3)
 							{
-								enqueue(client.outbuf, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
+								enqueue(client, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
 								return ;
 							}
 							{
 								std::string targetNick = params[2];
-								Client* targetClient = NULL;
-								for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
-								{
-									if ((*it)->getNick() == targetNick)
-									{
-										targetClient = *it;
-										break;
-									}
-								}
+								Client* targetClient = findNick(targetNick);
 								
 								if (targetClient && targetChannel->hasClient(targetClient))
 								{
-									if (adding)
-									{
-										targetChannel->addOperator(targetClient);
-									}
-									else
-									{
-										targetChannel->removeOperator(targetClient);
-									}
+									targetChannel->setFlag(targetClient, modeChar == 'o' ? MEMBER_OP : MEMBER_VOICE, adding);
 									
-									std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-									std::string modeMsg = ":" + userMask + " MODE " + target + " " + (adding ? "+o" : "-o") + " " + targetNick + "\r\n";
+									std::string modeMsg = client.getPrefix() + " MODE " + target + " " + (adding ? "+" : "-") + modeChar + " " + targetNick + "\r\n";
 									targetChannel->sendMsg(modeMsg, NULL);
 								}
 							}
@@ -117,7 +97,7 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 							{
 								if (params.size() < 3)
 								{
-									enqueue(client.outbuf, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
+									enqueue(client, ":server 461 " + client.getNick() + " MODE :Not enough parameters\r\n");
 									return ;
 								}
 								int limit = atoi(params[2].c_str());
@@ -125,7 +105,7 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 									targetChannel->setUserLimit(limit);
 								else
 								{
-									enqueue(client.outbuf, ":server 501 " + client.getNick() + " :Unknown MODE flag\r\n");
+									enqueue(client, ":server 501 " + client.getNick() + " :Unknown MODE flag\r\n");
 									return ;
 								}
 							}
@@ -135,7 +115,7 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 							}
 							break;
 						default:
-							enqueue(client.outbuf, ":server 472 " + client.getNick() + " " + modeChar + " :is unknown mode char to me\r\n");
+							enqueue(client, ":server 472 " + client.getNick() + " " + modeChar + " :is unknown mode char to me\r\n");
 							return;
 					}
 				}
@@ -146,26 +126,21 @@ void Server::handleMode(const std::vector<std::string>& params, Client &client)
 
 void Server::handleTopic(const std::vector<std::string>& params, Client &client)
 {
-	if (params.empty())
-	{
-		enqueue(client.outbuf, ":server 461 " + client.getNick() + " TOPIC :Not enough parameters\r\n");
-		return ;
-	}
-	
 	std::string channelName = params[0];
-	std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+	ChannelMap::iterator channelIt = this->channels.find(channelName);
 	
 	if (channelIt == this->channels.end())
 	{
-		enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+		enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
 		return ;
 	}
 	
 	Channel* targetChannel = channelIt->second;
+	channelName = targetChannel->getName();
 	
 	if (!targetChannel->hasClient(&client))
 	{
-		enqueue(client.outbuf, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
+		enqueue(client, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
 		return ;
 	}
 	
@@ -174,26 +149,25 @@ void Server::handleTopic(const std::vector<std::string>& params, Client &client)
 		std::string currentTopic = targetChannel->getTopic();
 		if (currentTopic.empty())
 		{
-			enqueue(client.outbuf, ":server 331 " + client.getNick() + " " + channelName + " :No topic is set\r\n");
+			enqueue(client, ":server 331 " + client.getNick() + " " + channelName + " :No topic is set\r\n");
 		}
 		else
 		{
-			enqueue(client.outbuf, ":server 332 " + client.getNick() + " " + channelName + " :" + currentTopic + "\r\n");
+			enqueue(client, ":server 332 " + client.getNick() + " " + channelName + " :" + currentTopic + "\r\n");
 		}
 	}
 	else
 	{
 		if (targetChannel->isTopicRestricted() && !targetChannel->isOperator(&client))
 		{
-			enqueue(client.outbuf, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
+			enqueue(client, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
 			return ;
 		}
 		
 		std::string newTopic = params[1];
 		targetChannel->setTopic(newTopic);
 		
-		std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-		std::string topicMsg = ":" + userMask + " TOPIC " + channelName + " :" + newTopic + "\r\n";
+		std::string topicMsg = client.getPrefix() + " TOPIC " + channelName + " :" + newTopic + "\r\n";
 		
 		targetChannel->sendMsg(topicMsg, NULL); // Kendine de gönder
 	}
@@ -206,8 +180,9 @@ void Server::handleName(const std::vector<std::string>& params, Client &client)
 	
 	if (channelList.empty())
 	{
-		for (std::map<std::string, Channel*>::iterator it = this->channels.begin(); it != this->channels.end(); ++it)
-			channelsToList.push_back(it->first);
+		const std::vector<Channel *> &sorted = sortedChannels();
+		for (size_t i = 0; i < sorted.size(); ++i)
+			channelsToList.push_back(sorted[i]->getName());
 	}
 	else
 	{
@@ -223,28 +198,19 @@ void Server::handleName(const std::vector<std::string>& params, Client &client)
 	for (size_t i = 0; i < channelsToList.size(); ++i)
 	{
 		std::string channelName = channelsToList[i];
-		std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+		ChannelMap::iterator channelIt = this->channels.find(channelName);
 		
 		if (channelIt == this->channels.end())
 		{
-			enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+			enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
 			continue ;
 		}
 		
 		Channel* targetChannel = channelIt->second;
+		channelName = targetChannel->getName();
 		
-		std::string namesList = "";
-		std::vector<Client*> members = targetChannel->getMembers();
-		for (size_t j = 0; j < members.size(); ++j)
-		{
-			if (j > 0) namesList += " ";
-			if (targetChannel->isOperator(members[j]))
-				namesList += "@";
-			namesList += members[j]->getNick();
-		}
-		
-		enqueue(client.outbuf, ":server 353 " + client.getNick() + " = " + channelName + " :" + namesList + "\r\n");
-		enqueue(client.outbuf, ":server 366 " + client.getNick() + " " + channelName + " :End of NAMES list\r\n");
+		enqueue(client, ":server 353 " + client.getNick() + " = " + channelName + " :" + targetChannel->namesList() + "\r\n");
+		enqueue(client, ":server 366 " + client.getNick() + " " + channelName + " :End of NAMES list\r\n");
 	}
 }
 
@@ -255,8 +221,9 @@ void Server::handleList(const std::vector<std::string>& params, Client &client)
 	
 	if (channelList.empty())
 	{
-		for (std::map<std::string, Channel*>::iterator it = this->channels.begin(); it != this->channels.end(); ++it)
-			channelsToList.push_back(it->first);
+		const std::vector<Channel *> &sorted = sortedChannels();
+		for (size_t i = 0; i < sorted.size(); ++i)
+			channelsToList.push_back(sorted[i]->getName());
 	}
 	else
 	{
@@ -272,12 +239,13 @@ void Server::handleList(const std::vector<std::string>& params, Client &client)
 	for (size_t i = 0; i < channelsToList.size(); ++i)
 	{
 		std::string channelName = channelsToList[i];
-		std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+		ChannelMap::iterator channelIt = this->channels.find(channelName);
 		
 		if (channelIt == this->channels.end())
 			continue ;
 		
 		Channel* targetChannel = channelIt->second;
+		channelName = targetChannel->getName();
 		
 		std::string topic = targetChannel->getTopic();
 		if (topic.empty())
@@ -285,139 +253,106 @@ void Server::handleList(const std::vector<std::string>& params, Client &client)
 		
 		std::string userCount = to_string(targetChannel->getMemberCount());
 		
-		enqueue(client.outbuf, ":server 322 " + client.getNick() + " " + channelName + " " + userCount + " :" + topic + "\r\n");
+		enqueue(client, ":server 322 " + client.getNick() + " " + channelName + " " + userCount + " :" + topic + "\r\n");
 	}
 	
-	enqueue(client.outbuf, ":server 323 " + client.getNick() + " :End of /LIST\r\n");
+	enqueue(client, ":server 323 " + client.getNick() + " :End of /LIST\r\n");
 }
 
 void Server::handleInvite(const std::vector<std::string>& params, Client &client)
 {
-	if (params.size() < 2)
-	{
-		enqueue(client.outbuf, ":server 461 " + client.getNick() + " INVITE :Not enough parameters\r\n");
-		return ;
-	}
-	
 	std::string targetNick = params[0];
 	std::string channelName = params[1];
 	
-	Client* targetClient = NULL;
-	for (size_t i = 0; i < clients.size(); ++i)
-	{
-		if (clients[i]->getNick() == targetNick)
-		{
-			targetClient = clients[i];
-			break ;
-		}
-	}
+	Client* targetClient = findNick(targetNick);
 	
 	if (targetClient == NULL)
 	{
-		enqueue(client.outbuf, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
+		enqueue(client, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
 		return ;
 	}
 	
-	std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+	ChannelMap::iterator channelIt = this->channels.find(channelName);
 	if (channelIt == this->channels.end())
 	{
-		enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+		enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
 		return ;
 	}
 	
 	Channel* targetChannel = channelIt->second;
+	channelName = targetChannel->getName();
 	
 	if (!targetChannel->hasClient(&client))
 	{
-		enqueue(client.outbuf, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
+		enqueue(client, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
 		return ;
 	}
 	
 	if (!targetChannel->isOperator(&client))
 	{
-		enqueue(client.outbuf, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
+		enqueue(client, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
 		return ;
 	}
 	
 	if (targetChannel->hasClient(targetClient))
 	{
-		enqueue(client.outbuf, ":server 443 " + client.getNick() + " " + targetNick + " " + channelName + " :is already on channel\r\n");
+		enqueue(client, ":server 443 " + client.getNick() + " " + targetNick + " " + channelName + " :is already on channel\r\n");
 		return ;
 	}
 	
-	std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-	std::string inviteMsg = ":" + userMask + " INVITE " + targetNick + " :" + channelName + "\r\n";
+	std::string inviteMsg = client.getPrefix() + " INVITE " + targetNick + " :" + channelName + "\r\n";
 	
-	enqueue(targetClient->outbuf, inviteMsg);
-	enqueue(client.outbuf, ":server 341 " + client.getNick() + " " + targetNick + " " + channelName + "\r\n");
+	enqueue(*targetClient, inviteMsg);
+	enqueue(client, ":server 341 " + client.getNick() + " " + targetNick + " " + channelName + "\r\n");
 	
-	targetChannel->inviteUser(targetNick);
+	targetChannel->inviteUser(targetClient->getNick());
 }
 
 void Server::handleKick(const std::vector<std::string>& params, Client &client)
 {
-	if (params.size() < 2)
-	{
-		enqueue(client.outbuf, ":server 461 " + client.getNick() + " KICK :Not enough parameters\r\n");
-		return ;
-	}
-	
 	std::string channelName = params[0];
 	std::string targetNick = params[1];
 	std::string kickMessage = (params.size() > 2) ? params[2] : "Kicked";
 	
-	std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+	ChannelMap::iterator channelIt = this->channels.find(channelName);
 	if (channelIt == this->channels.end())
 	{
-		enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+		enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
 		return ;
 	}
 	
 	Channel* targetChannel = channelIt->second;
+	channelName = targetChannel->getName();
 	
 	if (!targetChannel->hasClient(&client))
 	{
-		enqueue(client.outbuf, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
+		enqueue(client, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
 		return ;
 	}
 	
 	if (!targetChannel->isOperator(&client))
 	{
-		enqueue(client.outbuf, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
+		enqueue(client, ":server 482 " + client.getNick() + " " + channelName + " :You're not channel operator\r\n");
 		return ;
 	}
 	
-	Client* targetClient = NULL;
-	for (size_t i = 0; i < clients.size(); ++i)
-	{
-		if (clients[i]->getNick() == targetNick)
-		{
-			targetClient = clients[i];
-			break ;
-		}
-	}
+	Client* targetClient = findNick(targetNick);
 	
 	if (targetClient == NULL)
 	{
-		enqueue(client.outbuf, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
+		enqueue(client, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
 		return ;
 	}
 	
 	if (!targetChannel->hasClient(targetClient))
 	{
-		enqueue(client.outbuf, ":server 441 " + client.getNick() + " " + targetNick + " " + channelName + " :They aren't on that channel\r\n");
+		enqueue(client, ":server 441 " + client.getNick() + " " + targetNick + " " + channelName + " :They aren't on that channel\r\n");
 		return ;
 	}
 	
-	std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-	std::string kickMsg = ":" + userMask + " KICK " + channelName + " " + targetNick + " :" + kickMessage + "\r\n";
+	std::string kickMsg = client.getPrefix() + " KICK " + channelName + " " + targetNick + " :" + kickMessage + "\r\n";
 	targetChannel->sendMsg(kickMsg, NULL); // Herkesi dahil et
-	targetChannel->removeClient(targetClient);
-	if (targetChannel->getMemberCount() == 0)
-	{
-		delete targetChannel;
-		this->channels.erase(channelIt->first);
-	}
+	leaveChannel(targetChannel, *targetClient);
 }
 
 void Server::handleWho(const std::vector<std::string>& params, Client &client)
@@ -427,60 +362,52 @@ void Server::handleWho(const std::vector<std::string>& params, Client &client)
 	for (size_t i = 0; i < clients.size(); ++i)
 	{
 		Client* currentClient = clients[i];
-		if (mask.empty() || currentClient->getNick() == mask)
+		if (mask.empty() || ircEquals(currentClient->getNick(), mask))
 		{
 			std::string userInfo = currentClient->getNick() + " " + currentClient->getUname() + " " + currentClient->getHname() + " * :" + currentClient->getRname();
-			enqueue(client.outbuf, ":server 352 " + client.getNick() + " " + userInfo + "\r\n");
+			enqueue(client, ":server 352 " + client.getNick() + " " + userInfo + "\r\n");
 		}
 	}
 	
-	enqueue(client.outbuf, ":server 315 " + client.getNick() + " :End of /WHO list\r\n");
+	enqueue(client, ":server 315 " + client.getNick() + " :End of /WHO list\r\n");
 }
 
 void Server::handleWhois(const std::vector<std::string>& params, Client &client)
 {
-	if (params.empty())
-	{
-		enqueue(client.outbuf, ":server 461 " + client.getNick() + " WHOIS :Not enough parameters\r\n");
-		return ;
-	}
-	
 	std::string targetNick = params[0];
-	Client* targetClient = NULL;
-	for (size_t i = 0; i < clients.size(); ++i)
-	{
-		if (clients[i]->getNick() == targetNick)
-		{
-			targetClient = clients[i];
-			break ;
-		}
-	}
+	Client* targetClient = findNick(targetNick);
 	
 	if (targetClient == NULL)
 	{
-		enqueue(client.outbuf, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
+		enqueue(client, ":server 401 " + client.getNick() + " " + targetNick + " :No such nick/channel\r\n");
 		return ;
 	}
 	
 	std::string userInfo = targetClient->getNick() + " " + targetClient->getUname() + " " + targetClient->getHname() + " * :" + targetClient->getRname();
-	enqueue(client.outbuf, ":server 311 " + client.getNick() + " " + userInfo + "\r\n");
+	enqueue(client, ":server 311 " + client.getNick() + " " + userInfo + "\r\n");
 	
+	// küme adres sırasında; cevap her çalışmada aynı olsun diye ada göre sıralanır
+	const std::set<Channel*> &member = targetClient->getChannels();
+	std::vector<Channel*> joined(member.begin(), member.end());
+	std::sort(joined.begin(), joined.end(), ChannelNameLess());
 	std::string channelsList = "";
-	for (std::map<std::string, Channel*>::iterator it = this->channels.begin(); it != this->channels.end(); ++it)
+	for (std::vector<Channel*>::const_iterator it = joined.begin(); it != joined.end(); ++it)
 	{
-		if (it->second->hasClient(targetClient))
-		{
-			if (!channelsList.empty()) channelsList += " ";
-			if (it->second->isOperator(targetClient)) channelsList += "@";
-			channelsList += it->first;
-		}
+		if (!channelsList.empty()) channelsList += " ";
+		unsigned flags = (*it)->getFlags(targetClient);
+		if (flags & MEMBER_OP) channelsList += "@";
+		else if (flags & MEMBER_VOICE) channelsList += "+";
+		channelsList += (*it)->getName();
 	}
 	if (!channelsList.empty())
 	{
-		enqueue(client.outbuf, ":server 319 " + client.getNick() + " " + targetNick + " :" + channelsList + "\r\n");
+		enqueue(client, ":server 319 " + client.getNick() + " " + targetNick + " :" + channelsList + "\r\n");
 	}
 	
-	enqueue(client.outbuf, ":server 312 " + client.getNick() + " " + targetNick + " :server :IRC Server\r\n");
-	enqueue(client.outbuf, ":server 317 " + client.getNick() + " " + targetNick + " 0 :seconds idle\r\n");
-	enqueue(client.outbuf, ":server 318 " + client.getNick() + " " + targetNick + " :End of /WHOIS list\r\n");
+	enqueue(client, ":server 312 " + client.getNick() + " " + targetNick + " :server :IRC Server\r\n");
+	unsigned long long idle = (this->clock.monotonicMs() - targetClient->getLastActivity()) / 1000;
+	std::ostringstream idleInfo;
+	idleInfo << idle << ' ' << targetClient->getSignon();
+	enqueue(client, ":server 317 " + client.getNick() + " " + targetNick + " " + idleInfo.str() + " :seconds idle, signon time\r\n");
+	enqueue(client, ":server 318 " + client.getNick() + " " + targetNick + " :End of /WHOIS list\r\n");
 }
@@ -8,252 +8,220 @@ void Server::checkRegistration(Client &client)
     {
         client.setRegis(true);
         
-        std::string fullmask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-        
-        enqueue(client.outbuf, ":server 001 " + client.getNick() + " :Welcome to the Internet Relay Network " + fullmask + "\r\n");
-        enqueue(client.outbuf, ":server 002 " + client.getNick() + " :Your host is server, running version 1.0\r\n");
-        enqueue(client.outbuf, ":server 003 " + client.getNick() + " :This server was created\r\n");//tarih eklemeyi unutma
-        enqueue(client.outbuf, ":server 004 " + client.getNick() + " server 1.0 o o\r\n");
+        // prefix ":nick!user@host", baştaki ':' olmadan
+        enqueue(client, ":server 001 " + client.getNick() + " :Welcome to the Internet Relay Network " + client.getPrefix().substr(1) + "\r\n");
+        enqueue(client, ":server 002 " + client.getNick() + " :Your host is server, running version 1.0\r\n");
+        enqueue(client, ":server 003 " + client.getNick() + " :This server was created " + Clock::format(this->created) + "\r\n");
+        enqueue(client, ":server 004 " + client.getNick() + " server 1.0 o o\r\n");
         // MOTD yoksa bunu gönder (HexChat bekleyebilir)
-        enqueue(client.outbuf, ":server 422 " + client.getNick() + " :MOTD File is missing\r\n");
+        enqueue(client, ":server 422 " + client.getNick() + " :MOTD File is missing\r\n");
+        // kayıt süresinin yerine PING/idle zamanlaması kurulur; idle süresi kayıttan başlar.
+        // keepalive() burada çağrılmaz: komut işlenirken client kapatılıp silinebilirdi
+        unsigned long long now = this->clock.monotonicMs();
+        client.setLastInput(now);
+        client.setLastActivity(now);
+        unsigned long long wake = now + this->pingInterval * 1000ULL;
+        if (this->idleTimeout)
+            wake = std::min(wake, now + this->idleTimeout * 1000ULL);
+        this->timers.schedule(client.getTimer(), wake);
     }
 }
 
 
-bool Server::nicknameCheck(std::string nickname)
+Client *Server::findNick(const std::string &nick)
+{
+    NickMap::iterator it = this->nicks.find(nick);
+    return it == this->nicks.end() ? NULL : it->second;
+}
+
+Channel *Server::findChannel(const std::string &name)
 {
-    for (std::vector<Client *>::iterator it = clients.begin(); it != clients.end(); ++it)
+    ChannelMap::iterator it = this->channels.find(name);
+    return it == this->channels.end() ? NULL : it->second;
+}
+
+// sıralı görünüm yalnızca LIST/NAMES isteyince ve kanal kümesi değiştiyse kurulur
+const std::vector<Channel *> &Server::sortedChannels()
+{
+    if (this->channelOrderStale)
     {
-        if ((*it)->getNick() == nickname)
-        {
-            return false;
-        }
+        this->channelOrder.clear();
+        this->channelOrder.reserve(this->channels.size());
+        for (ChannelMap::iterator it = this->channels.begin(); it != this->channels.end(); ++it)
+            this->channelOrder.push_back(it->second);
+        std::sort(this->channelOrder.begin(), this->channelOrder.end(), ChannelNameLess());
+        this->channelOrderStale = false;
     }
-    return true;
+    return this->channelOrder;
 }
 
-void Server::commandHandler(std::string cmd, std::vector<std::string> params, Client &client)
+void Server::commandHandler(const std::string &cmd, const std::vector<std::string> &params, Client &client, size_t bytes)
 {
-    if (cmd == "CAP")//cap bak
+    const CommandEntry *entry = findCommand(cmd.data(), cmd.size());
+    if (!entry)
     {
+        // Bilinmeyen komut
         std::string nickOrStar = client.getNick().empty() ? "*" : client.getNick();
-        if (params.empty())
-        {
-            enqueue(client.outbuf, ":server 461 " + nickOrStar + " CAP :Not enough parameters\r\n");
-            return;
-        }
-        std::string sub = params[0];
-        if (sub == "LS")
-        {
-            // Desteklenen capability yok: boş liste
-            enqueue(client.outbuf, ":server CAP " + nickOrStar + " LS :\r\n");
-        }
-        else if (sub == "LIST")
-        {
-            enqueue(client.outbuf, ":server CAP " + nickOrStar + " LIST :\r\n");
-        }
-        else if (sub == "REQ")
-        {
-            std::string req = params.size() > 1 ? params[1] : "";
-            enqueue(client.outbuf, ":server CAP " + nickOrStar + " NAK :" + req + "\r\n");
-        }
-        else if (sub == "END")
-        {
-            // noop
-        }
-        else
-        {
-            enqueue(client.outbuf, ":server 421 " + nickOrStar + " CAP :Unknown command\r\n");
-        }
+        enqueue(client, ":server 421 " + nickOrStar + " " + cmd + " :Unknown command\r\n");
         return;
     }
-
-    if(cmd == "PASS")
+    // Kayıt tamamlanmadan bu komutlara izin verme
+    if (entry->needsRegistration && !client.getRegis())
     {
-        if (params.empty())
-        {
-            enqueue(client.outbuf, ":server 461 * PASS :Not enough parameters\r\n");
-            return;
-        }
-        if (client.getAuth())
-        {
-            enqueue(client.outbuf, ":server 462 * :You may not reregister\r\n");
-            return;
-        }
-        
-        client.setAuth(params[0] == this->password);
-        
-        if (!client.getAuth())
-        {
-            enqueue(client.outbuf, ":server 464 * :Password incorrect\r\n");
-            return;
-        }
-        checkRegistration(client);
-        return ;
-    }
-
-    if (cmd == "NICK")
-    {
-        if (params.empty())
-        {
-            enqueue(client.outbuf, ":server 431 * :No nickname given\r\n");
-            return;
-        }
-        
-        std::string nickname = params[0];
-        if (nickname.find(' ') != std::string::npos || nickname.empty())
-        {
-            enqueue(client.outbuf, ":server 432 * " + nickname + " :Erroneous nickname\r\n");
-            return;
-        }
-        
-        if (nickname != client.getNick() && !nicknameCheck(nickname))
-        {
-            std::string target = client.getNick().empty() ? "*" : client.getNick();
-            enqueue(client.outbuf, ":server 433 " + target + " " + nickname + " :Nickname is already in use\r\n");
-            return;
-        }
-        
-        client.setNick(nickname);
-        checkRegistration(client);
+        enqueue(client, ":server 451 * :You have not registered\r\n");
         return;
     }
-    else if (cmd == "USER")
+    if (params.size() < entry->minParams)
     {
-        if (params.size() < 4)
-        {
-            enqueue(client.outbuf, ":server 461 * USER :Not enough parameters\r\n");
-            return;
-        }
-        
-        if (client.getRegis())
-        {
-            enqueue(client.outbuf, ":server 462 * :You may not reregister\r\n");
-            return;
-        }
-        
-        std::string username = params[0];
-        std::string hostname = params[1];
-        std::string servername = params[2];    
-        std::string realname = params[3];      
-        
-        if (username.empty() || username.find(' ') != std::string::npos)
-        {
-            enqueue(client.outbuf, ":server 461 * USER :Invalid username\r\n");
-            return;
-        }
-        
-        client.setUname(username);
-        client.setRname(realname);
-        client.setHname(hostname); 
-        
-        checkRegistration(client);
+        std::string target = client.getRegis() ? client.getNick() : "*";
+        enqueue(client, ":server 461 " + target + " " + entry->name + " :Not enough parameters\r\n");
         return;
     }
+    // sürekli açık ölçüm: iki TSC okuması ve birkaç sayaç; client handler'dan sonra silinmiş olabilir
+    CommandStats &stats = this->commandStats[commandIndex(entry)];
+    int fd = client.getFd();
+    unsigned long long queued = Client::queuedBytes();
+    unsigned long long lines = Client::queuedMessages();
+    unsigned long long start = Clock::cycles();
+    (this->*entry->handler)(params, client);
+    unsigned long long elapsed = Clock::cycles() - start;
+    stats.latency.record(elapsed);
+    stats.bytesIn += bytes;
+    stats.bytesOut += Client::queuedBytes() - queued;
+    stats.messagesOut += Client::queuedMessages() - lines;
+    if (elapsed >= this->loop.slowLimit)
+        slowCommand(*entry, params, fd, elapsed);
+}
 
-    // hechat için kayıt öncesi ping, pong, quite izin verilmeli
-    if (cmd == "PING")
+void Server::handleCap(const std::vector<std::string>& params, Client &client)//cap bak
+{
+    std::string nickOrStar = client.getNick().empty() ? "*" : client.getNick();
+    std::string sub = params[0];
+    if (sub == "LS")
     {
-        if (params.empty())
-        {
-            enqueue(client.outbuf, ":server 409 * :No origin specified\r\n");
-            return;
-        }
-        enqueue(client.outbuf, ":server PONG server :" + params[0] + "\r\n");
-        return;
+        // Desteklenen capability yok: boş liste
+        enqueue(client, ":server CAP " + nickOrStar + " LS :\r\n");
     }
-    else if (cmd == "PONG")
+    else if (sub == "LIST")
     {
-        return;
+        enqueue(client, ":server CAP " + nickOrStar + " LIST :\r\n");
     }
-    else if (cmd == "QUIT")
+    else if (sub == "REQ")
     {
-        handleQuit(params, client);
-        return;
+        std::string req = params.size() > 1 ? params[1] : "";
+        enqueue(client, ":server CAP " + nickOrStar + " NAK :" + req + "\r\n");
     }
-
-    // Bilinen komutları kontrol et
-    if (cmd == "JOIN" || cmd == "PRIVMSG" || cmd == "PART" || cmd == "NOTICE" || 
-        cmd == "MODE" || cmd == "TOPIC" || cmd == "NAMES" || cmd == "LIST" || 
-        cmd == "INVITE" || cmd == "KICK" || cmd == "WHO" || cmd == "WHOIS" || cmd == "MOTD" || cmd == "AWAY" || cmd == "BACK")
+    else if (sub == "END")
     {
-        // Kayıt tamamlanmadan bu komutlara izin verme
-        if (!client.getRegis())
-        {
-            enqueue(client.outbuf, ":server 451 * :You have not registered\r\n");
-            return ;
-        }
+        // noop
     }
     else
     {
-        // Bilinmeyen komut
-        std::string nickOrStar = client.getNick().empty() ? "*" : client.getNick();
-        enqueue(client.outbuf, ":server 421 " + nickOrStar + " " + cmd + " :Unknown command\r\n");
-        return;
+        enqueue(client, ":server 421 " + nickOrStar + " CAP :Unknown command\r\n");
     }
+}
 
-    if (cmd == "MOTD")//motd dosyamız yok, gerek de yok
+void Server::handlePass(const std::vector<std::string>& params, Client &client)
+{
+    if (client.getAuth())
     {
-        enqueue(client.outbuf, ":server 422 " + client.getNick() + " :MOTD File is missing\r\n");
+        enqueue(client, ":server 462 * :You may not reregister\r\n");
         return;
     }
-
-    if (cmd == "JOIN")
-    {
-        handleJoin(params, client);
-    }
-    else if (cmd == "PRIVMSG")
-    {
-        handlePrivMsg(params, client);
-    }
-    else if (cmd == "PART")
-    {
-        handlePart(params, client);
-    }
-    else if (cmd == "NOTICE")
-    {
-        handleNotice(params, client);
-    }
-    else if (cmd == "MODE")
-    {
-        handleMode(params, client);
-    }
-    else if (cmd == "TOPIC")
-    {
-        handleTopic(params, client);
-    }
-    else if (cmd == "NAMES")
-    {
-        handleName(params, client);
-    }
-    else if (cmd == "LIST")
+    
+    client.setAuth(params[0] == this->password);
+    
+    if (!client.getAuth())
     {
-        handleList(params, client);
+        enqueue(client, ":server 464 * :Password incorrect\r\n");
+        return;
     }
-    else if (cmd == "INVITE")
+    checkRegistration(client);
+}
+
+void Server::handleNick(const std::vector<std::string>& params, Client &client)
+{
+    if (params.empty())
     {
-        handleInvite(params, client);
+        enqueue(client, ":server 431 * :No nickname given\r\n");
+        return;
     }
-    else if (cmd == "KICK")
+    
+    std::string nickname = params[0];
+    if (nickname.find(' ') != std::string::npos || nickname.empty())
     {
-        handleKick(params, client);
+        enqueue(client, ":server 432 * " + nickname + " :Erroneous nickname\r\n");
+        return;
     }
-    else if (cmd == "WHO")
+    
+    // kendi nick'inin büyük/küçük harf değişikliği serbest
+    Client *owner = findNick(nickname);
+    if (owner && owner != &client)
     {
-        handleWho(params, client);
+        std::string target = client.getNick().empty() ? "*" : client.getNick();
+        enqueue(client, ":server 433 " + target + " " + nickname + " :Nickname is already in use\r\n");
+        return;
     }
-    else if (cmd == "WHOIS")
+    
+    if (!client.getNick().empty())
+        this->nicks.erase(client.getNick());
+    client.setNick(nickname);
+    this->nicks[nickname] = &client;
+    checkRegistration(client);
+}
+
+void Server::handleUser(const std::vector<std::string>& params, Client &client)
+{
+    if (client.getRegis())
     {
-        handleWhois(params, client);
+        enqueue(client, ":server 462 * :You may not reregister\r\n");
+        return;
     }
-    else if (cmd == "AWAY")
+    
+    std::string username = params[0];
+    std::string hostname = params[1];
+    std::string servername = params[2];    
+    std::string realname = params[3];      
+    
+    if (username.empty() || username.find(' ') != std::string::npos)
     {
-        handleAway(params, client);
+        enqueue(client, ":server 461 * USER :Invalid username\r\n");
+        return;
     }
-    else if (cmd == "BACK")
+    
+    client.setUname(username);
+    client.setRname(realname);
+    client.setHname(hostname); 
+    
+    checkRegistration(client);
+}
+
+// hechat için kayıt öncesi ping, pong, quite izin verilmeli
+void Server::handlePing(const std::vector<std::string>& params, Client &client)
+{
+    if (params.empty())
     {
-        std::vector<std::string> emptyParams;
-        handleAway(emptyParams, client);
+        enqueue(client, ":server 409 * :No origin specified\r\n");
+        return;
     }
-    
-}
\ No newline at end of file
+    enqueue(client, ":server PONG server :" + params[0] + "\r\n");
+}
+
+void Server::handlePong(const std::vector<std::string>& params, Client &client)
+{
+    (void)params;
+    (void)client;
+}
+
+void Server::handleMotd(const std::vector<std::string>& params, Client &client)//motd dosyamız yok, gerek de yok
+{
+    (void)params;
+    enqueue(client, ":server 422 " + client.getNick() + " :MOTD File is missing\r\n");
+}
+
+void Server::handleBack(const std::vector<std::string>& params, Client &client)
+{
+    (void)params;
+    std::vector<std::string> emptyParams;
+    handleAway(emptyParams, client);
+}
@@ -0,0 +1,320 @@
+#include "../include/Server.hpp"
+#include <sys/un.h>
+#include <sys/stat.h>
+
+#define SENDQ_DEPTHS 6 // irc_sendq_depth_clients sınırları, +Inf hariç
+
+static const unsigned long sendqDepths[SENDQ_DEPTHS] = { 0, 512, 4096, 32768, 262144, 1048576 };
+
+void Server::setMetricsSocket(const std::string &path)
+{
+	this->metricsPath = path;
+}
+
+// Unix soketi reactor'a listener olarak eklenir; scrape'ler olay döngüsünde, client'larla aynı turda
+// cevaplanır. Yoldaki eski soket dosyası (önceki çalışmadan kalan) silinir, başka bir dosya silinmez.
+void Server::openMetrics()
+{
+	if (this->metricsPath.empty())
+		return;
+	struct sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (this->metricsPath.size() >= sizeof(addr.sun_path))
+		throw(std::runtime_error("--metrics path is too long: " + this->metricsPath));
+	std::memcpy(addr.sun_path, this->metricsPath.c_str(), this->metricsPath.size());
+
+	struct stat st;
+	if (lstat(addr.sun_path, &st) == 0)
+	{
+		if (!S_ISSOCK(st.st_mode))
+			throw(std::runtime_error("--metrics path exists and is not a socket: " + this->metricsPath));
+		unlink(addr.sun_path);
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		throw(std::runtime_error("Metrics socket error."));
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, BACKLOG) < 0)
+	{
+		close(fd);
+		throw(std::runtime_error("Error while binding metrics socket " + this->metricsPath + ": " + strerror(errno)));
+	}
+	setNonBlocking(fd);
+	this->metricsFd = fd;
+	this->reactor->addListener(fd);
+	LOG(CORE, INFO) << "Metrics on unix:" << this->metricsPath;
+}
+
+void Server::closeMetrics()
+{
+	while (!this->scrapes.empty())
+		closeScrape(this->scrapes.begin()->first);
+	if (this->metricsFd < 0)
+		return;
+	this->reactor->remove(this->metricsFd);
+	close(this->metricsFd);
+	unlink(this->metricsPath.c_str());
+	this->metricsFd = -1;
+}
+
+void Server::closeScrape(int fd)
+{
+	std::map<int, MetricsScrape *>::iterator it = this->scrapes.find(fd);
+	if (it == this->scrapes.end())
+		return;
+	this->timers.cancel(it->second->deadline);
+	delete it->second;
+	this->scrapes.erase(it);
+	this->reactor->remove(fd);
+	close(fd);
+}
+
+void Server::serveMetrics(const ReactorEvent &event)
+{
+	int fd = event.fd;
+	if (fd == this->metricsFd)
+	{
+		int scrapeFd = (event.events & Reactor::ACCEPTED) ? event.result : accept(fd, NULL, NULL);
+		if (scrapeFd < 0)
+			return;
+		if (this->scrapes.size() >= METRICS_MAX_SCRAPES)
+		{
+			LOG(NET, WARN) << "Metrics scrape refused, " << METRICS_MAX_SCRAPES << " already open";
+			close(scrapeFd);
+			return;
+		}
+		if (!this->reactor->completionBased())
+			setNonBlocking(scrapeFd);
+		MetricsScrape *scrape = new MetricsScrape(scrapeFd);
+		this->scrapes[scrapeFd] = scrape;
+		scrape->deadline.kind = TIMER_SCRAPE;
+		scrape->deadline.data = scrape;
+		this->timers.schedule(scrape->deadline, this->clock.monotonicMs() + METRICS_TIMEOUT_MS);
+		this->reactor->add(scrapeFd, Reactor::READ);
+		return;
+	}
+
+	MetricsScrape &scrape = *this->scrapes[fd];
+	if (scrape.answered)
+	{
+		// io_uring: WRITE gönderim bitti demek; HANGUP'ta sonuç 0 ise yalnızca karşı taraf yazmayı kapattı
+		if ((event.events & Reactor::HANGUP) && event.result == 0)
+			return;
+		if (event.events & Reactor::WRITE)
+			sendScrape(scrape);
+		else
+			closeScrape(fd);
+		return;
+	}
+	bool eof = false;
+	if (event.events & Reactor::DATA)
+		scrape.request.append(event.data, event.result);
+	if (event.events & Reactor::HANGUP)
+	{
+		if (event.result < 0)
+		{
+			closeScrape(fd);
+			return;
+		}
+		eof = true;
+	}
+	if (event.events & (Reactor::READ | Reactor::ERROR))
+	{
+		char buf[BUF_SIZE];
+		ssize_t n;
+		while ((n = recv(fd, buf, sizeof(buf), 0)) > 0 && scrape.request.size() <= METRICS_REQUEST_MAX)
+			scrape.request.append(buf, n);
+		if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+		{
+			closeScrape(fd);
+			return;
+		}
+		if (n == 0)
+			eof = true;
+	}
+	if (eof || scrape.complete())
+		answerScrape(scrape);
+	else if (scrape.request.size() > METRICS_REQUEST_MAX)
+		closeScrape(fd);
+}
+
+// HTTP isteğine başlıklarla, başka her şeye (boş satır, EOF) yalnızca metinle cevap verilir
+void Server::answerScrape(MetricsScrape &scrape)
+{
+	std::string body;
+	std::string response;
+	if (!scrape.isHttp())
+		renderMetrics(response);
+	else
+	{
+		const std::string &request = scrape.request;
+		size_t space = request.find(' ');
+		std::string method = request.substr(0, space);
+		std::string path = request.substr(space + 1, request.find(' ', space + 1) - space - 1);
+		const char *status = "200 OK";
+		if (method != "GET" && method != "HEAD")
+			status = "405 Method Not Allowed";
+		else if (path != "/metrics" && path != "/")
+			status = "404 Not Found";
+		if (status[0] == '2')
+			renderMetrics(body);
+		else
+			body = std::string(status + 4) + "\n";
+		response = std::string("HTTP/1.0 ") + status + "\r\n"
+			"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			"Content-Length: " + to_string(body.size()) + "\r\n"
+			"Connection: close\r\n\r\n";
+		if (method != "HEAD")
+			response += body;
+	}
+	scrape.answered = true;
+	++this->connStats.scrapes;
+	scrape.response.adopt(response, 0);
+	sendScrape(scrape);
+}
+
+// client'larla aynı yol: hazırlık tabanlıda soket dolana kadar, io_uring'de tek send
+void Server::sendScrape(MetricsScrape &scrape)
+{
+	int fd = scrape.fd;
+	if (this->reactor->completionBased())
+	{
+		// kuyruk boşsa gönderim tamamlandı (WRITE)
+		if (scrape.response.empty())
+			closeScrape(fd);
+		else
+			this->reactor->submitSend(fd, scrape.response);
+		return;
+	}
+	while (!scrape.response.empty())
+	{
+		size_t offered;
+		ssize_t sent = scrape.response.writeTo(fd, offered);
+		if (sent > 0)
+			continue;
+		if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+			break;
+		// yalnızca WRITE: karşı taraf yazmayı kapattıysa READ her turda uyandırırdı
+		this->reactor->modify(fd, Reactor::WRITE);
+		return;
+	}
+	closeScrape(fd);
+}
+
+// Prometheus metin formatı. Sayaçlar olay anında tutulur; client sayıları ve SendQ
+// dağılımı scrape anında client listesi bir kez gezilerek hesaplanır.
+void Server::renderMetrics(std::string &out)
+{
+	MetricsText text(out);
+	double seconds = this->clock.cycleNs() / 1e9;
+
+	size_t registered = 0;
+	unsigned long long queued = 0;
+	unsigned long long depths[SENDQ_DEPTHS + 1] = { 0 };
+	for (size_t i = 0; i < this->clients.size(); ++i)
+	{
+		Client &client = *this->clients[i];
+		if (client.getRegis())
+			++registered;
+		size_t depth = client.outbuf.size();
+		queued += depth;
+		int bucket = 0;
+		while (bucket < SENDQ_DEPTHS && depth > sendqDepths[bucket])
+			++bucket;
+		++depths[bucket];
+	}
+
+	text.family("irc_start_time_seconds", "gauge", "Unix time the server started.");
+	text.sample("irc_start_time_seconds", "", (unsigned long long)this->created);
+	text.family("irc_clients_connected", "gauge", "Open client connections.");
+	text.sample("irc_clients_connected", "", (unsigned long long)this->clients.size());
+	text.family("irc_clients_registered", "gauge", "Clients that completed registration.");
+	text.sample("irc_clients_registered", "", (unsigned long long)registered);
+	text.family("irc_channels", "gauge", "Channels that exist.");
+	text.sample("irc_channels", "", (unsigned long long)this->channels.size());
+	text.family("irc_connections_accepted_total", "counter", "Client connections accepted.");
+	text.sample("irc_connections_accepted_total", "", this->connStats.accepted);
+	text.family("irc_disconnects_total", "counter", "Client connections closed, by reason.");
+	for (int i = 0; i < DISCONNECT_REASONS; ++i)
+		text.sample("irc_disconnects_total", MetricsText::label("reason", ConnectionStats::reasonName(i)),
+			this->connStats.disconnects[i]);
+
+	text.family("irc_command_calls_total", "counter", "Commands handled, by command.");
+	for (size_t i = 0; i < this->commandStats.size(); ++i)
+		text.sample("irc_command_calls_total", MetricsText::label("command", commandAt(i).name),
+			this->commandStats[i].latency.count());
+	text.family("irc_command_received_bytes_total", "counter", "Bytes of command lines received, by command.");
+	for (size_t i = 0; i < this->commandStats.size(); ++i)
+		text.sample("irc_command_received_bytes_total", MetricsText::label("command", commandAt(i).name),
+			this->commandStats[i].bytesIn);
+	text.family("irc_command_sent_messages_total", "counter", "IRC lines queued to any client while a command ran, by command.");
+	for (size_t i = 0; i < this->commandStats.size(); ++i)
+		text.sample("irc_command_sent_messages_total", MetricsText::label("command", commandAt(i).name),
+			this->commandStats[i].messagesOut);
+	text.family("irc_command_sent_bytes_total", "counter", "Bytes queued to any client while a command ran, by command.");
+	for (size_t i = 0; i < this->commandStats.size(); ++i)
+		text.sample("irc_command_sent_bytes_total", MetricsText::label("command", commandAt(i).name),
+			this->commandStats[i].bytesOut);
+	text.family("irc_command_duration_seconds", "summary", "Handler run time, by command.");
+	static const char *quantiles[] = { "0.5", "0.99", "0.999" };
+	static const double fractions[] = { 0.5, 0.99, 0.999 };
+	for (size_t i = 0; i < this->commandStats.size(); ++i)
+	{
+		const Histogram &latency = this->commandStats[i].latency;
+		const char *name = commandAt(i).name;
+		for (int q = 0; q < 3; ++q)
+			text.sample("irc_command_duration_seconds", MetricsText::label("command", name, "quantile", quantiles[q]),
+				latency.percentile(fractions[q]) * seconds);
+		text.sample("irc_command_duration_seconds_sum", MetricsText::label("command", name), latency.sum() * seconds);
+		text.sample("irc_command_duration_seconds_count", MetricsText::label("command", name), latency.count());
+	}
+
+	text.family("irc_sendq_bytes", "gauge", "Output queued to clients and not sent yet.");
+	text.sample("irc_sendq_bytes", "", queued);
+	text.family("irc_sendq_depth_clients", "gauge", "Clients with at most le bytes of unsent output (with --workers, output waiting in a worker is not seen).");
+	unsigned long long below = 0;
+	for (int i = 0; i <= SENDQ_DEPTHS; ++i)
+	{
+		below += depths[i];
+		text.sample("irc_sendq_depth_clients", MetricsText::label("le", i < SENDQ_DEPTHS ? to_string((int)sendqDepths[i]) : "+Inf"), below);
+	}
+	text.family("irc_sendq_excess_total", "counter", "Clients disconnected for going over a SendQ limit, by class and limit.");
+	for (int i = 0; i < SendQClass::COUNT; ++i)
+	{
+		text.sample("irc_sendq_excess_total", MetricsText::label("class", this->sendq[i].name, "limit", "bytes"),
+			(unsigned long long)this->sendq[i].excessBytes);
+		text.sample("irc_sendq_excess_total", MetricsText::label("class", this->sendq[i].name, "limit", "messages"),
+			(unsigned long long)this->sendq[i].excessMessages);
+	}
+
+	const LoopStats &loop = this->loop;
+	text.family("irc_loop_busy_seconds_total", "counter", "Event loop time spent handling events, timers and flushes.");
+	text.sample("irc_loop_busy_seconds_total", "", loop.worked * seconds);
+	text.family("irc_loop_wait_seconds_total", "counter", "Event loop time spent waiting for events.");
+	text.sample("irc_loop_wait_seconds_total", "", loop.waited * seconds);
+	text.family("irc_loop_turn_seconds", "summary", "Busy time of one event loop turn.");
+	for (int q = 0; q < 3; ++q)
+		text.sample("irc_loop_turn_seconds", MetricsText::label("quantile", quantiles[q]),
+			loop.busy.percentile(fractions[q]) * seconds);
+	text.sample("irc_loop_turn_seconds_sum", "", loop.busy.sum() * seconds);
+	text.sample("irc_loop_turn_seconds_count", "", loop.busy.count());
+	text.family("irc_loop_slow_turns_total", "counter", "Event loop turns busy for longer than threshold seconds.");
+	static const char *thresholds[LAG_LEVELS] = { "0.001", "0.01", "0.1" };
+	for (int i = 0; i < LAG_LEVELS; ++i)
+		text.sample("irc_loop_slow_turns_total", MetricsText::label("threshold", thresholds[i]), loop.over[i]);
+	text.family("irc_slow_commands_total", "counter", "Commands that ran longer than --slow-ms.");
+	text.sample("irc_slow_commands_total", "", (unsigned long long)loop.slowCommands);
+
+	const BufferPoolStats &buffers = BufferPool::stats();
+	text.family("irc_buffer_bytes", "gauge", "Pooled I/O buffer memory, by state.");
+	text.sample("irc_buffer_bytes", MetricsText::label("state", "borrowed"), (unsigned long long)buffers.borrowedBytes);
+	text.sample("irc_buffer_bytes", MetricsText::label("state", "cached"), (unsigned long long)buffers.cachedBytes);
+	text.family("irc_timers", "gauge", "Timers scheduled on the timer wheel.");
+	text.sample("irc_timers", "", (unsigned long long)this->timers.size());
+	LogStats log = Log::stats();
+	text.family("irc_log_records_total", "counter", "Log records, by outcome.");
+	text.sample("irc_log_records_total", MetricsText::label("outcome", "written"), (unsigned long long)log.written);
+	text.sample("irc_log_records_total", MetricsText::label("outcome", "dropped"), (unsigned long long)log.dropped);
+	text.family("irc_metrics_scrapes_total", "counter", "Metrics responses sent before this one.");
+	text.sample("irc_metrics_scrapes_total", "", this->connStats.scrapes);
+}
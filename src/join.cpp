@@ -3,12 +3,6 @@
 
 void Server::handlePart(const std::vector<std::string>& params, Client &client)
 {
-    if (params.empty())
-    {
-        enqueue(client.outbuf, ":server 461 " + client.getNick() + " PART :Not enough parameters\r\n");
-        return;
-    }
-    
     std::string channels = params[0];
     std::string partMessage = (params.size() > 1) ? params[1] : "";
     
@@ -29,26 +23,26 @@ void Server::handlePart(const std::vector<std::string>& params, Client &client)
         std::string channelName = channelList[i];
         
         // Kanal var mı kontrol et
-        std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+        ChannelMap::iterator channelIt = this->channels.find(channelName);
         
         if (channelIt == this->channels.end())
         {
-            enqueue(client.outbuf, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
+            enqueue(client, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
             continue;
         }
         
         Channel* targetChannel = channelIt->second;
+        channelName = targetChannel->getName();
         
         // Client kanalda mı kontrol et
         if (!targetChannel->hasClient(&client))
         {
-            enqueue(client.outbuf, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
+            enqueue(client, ":server 442 " + client.getNick() + " " + channelName + " :You're not on that channel\r\n");
             continue;
         }
         
         // PART mesajını hazırla
-        std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-        std::string partMsg = ":" + userMask + " PART " + channelName;
+        std::string partMsg = client.getPrefix() + " PART " + channelName;
         if (!partMessage.empty())
         {
             partMsg += " :" + partMessage;
@@ -58,32 +52,40 @@ void Server::handlePart(const std::vector<std::string>& params, Client &client)
         // Kanaldaki herkese PART mesajı gönder (kendini de dahil et)
         targetChannel->sendMsg(partMsg, NULL);
         
-        // Client'ı kanaldan çıkar
-        targetChannel->removeClient(&client);
-        
-        // Eğer kanal boş kaldıysa, kanalı sil
-        if (targetChannel->getMemberCount() == 0)
-        {
-            delete targetChannel;
-            this->channels.erase(channelName);
-        }
+        leaveChannel(targetChannel, client);
     }
 }
 
-void Server::handleJoin(const std::vector<std::string>& params, Client &client)
+// client'ı kanaldan çıkarır, boş kalan kanalı siler
+void Server::leaveChannel(Channel *channel, Client &client)
 {
-    if (params.empty())
+    channel->removeClient(&client);
+    if (channel->getMemberCount() == 0)
     {
-        enqueue(client.outbuf, ":server 461 " + client.getNick() + " JOIN :Not enough parameters\r\n");
-        return;
+        this->channels.erase(channel->getName());
+        this->channelOrderStale = true;
+        channelPool.destroy(channel);
     }
-    
+}
+
+void Server::handleJoin(const std::vector<std::string>& params, Client &client)
+{
     std::string channels = params[0];
     std::string keys = (params.size() > 1) ? params[1] : "";
     
     // /join 0 bütün kanallardan ayrılmanı sağlar hexchatte
     if (channels == "0")
     {
+        // her kanal için parametresiz PART
+        std::string joined;
+        for (std::set<Channel*>::const_iterator it = client.getChannels().begin(); it != client.getChannels().end(); ++it)
+        {
+            if (!joined.empty())
+                joined += ",";
+            joined += (*it)->getName();
+        }
+        if (!joined.empty())
+            handlePart(std::vector<std::string>(1, joined), client);
         return;
     }
     
@@ -118,14 +120,14 @@ void Server::handleJoin(const std::vector<std::string>& params, Client &client)
         
         if (channelName.empty() || (channelName[0] != '#' && channelName[0] != '&'))
         {
-            enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+            enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
             continue;
         }
         
         // rfc 2812 kanal ismi maksimum 50 karakterden oluşabilir.
         if (channelName.length() > 50)
         {
-            enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+            enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
             continue;
         }
         
@@ -133,22 +135,25 @@ void Server::handleJoin(const std::vector<std::string>& params, Client &client)
             channelName.find('\7') != std::string::npos || 
             channelName.find(',') != std::string::npos)
         {
-            enqueue(client.outbuf, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
+            enqueue(client, ":server 403 " + client.getNick() + " " + channelName + " :No such channel\r\n");
             continue;
         }
         
         // kanal yoksa oluştur
         Channel* targetChannel = NULL;
-        std::map<std::string, Channel*>::iterator channelIt = this->channels.find(channelName);
+        ChannelMap::iterator channelIt = this->channels.find(channelName);
         
         if (channelIt == this->channels.end())
         {
-            targetChannel = new Channel(channelName);
+            targetChannel = channelPool.create(channelName);
             this->channels[channelName] = targetChannel;
+            this->channelOrderStale = true;
         }
         else
         {
+            // #Foo varken JOIN #foo: cevaplar kanalın asıl adıyla gider
             targetChannel = channelIt->second;
+            channelName = targetChannel->getName();
         }
         
         //userı kanala eklemek
@@ -156,50 +161,37 @@ void Server::handleJoin(const std::vector<std::string>& params, Client &client)
         {
             if (targetChannel->isInviteOnly() && !targetChannel->isInvited(client.getNick()))
             {
-                enqueue(client.outbuf, ":server 473 " + client.getNick() + " " + channelName + " :Cannot join channel (+i)\r\n");
+                enqueue(client, ":server 473 " + client.getNick() + " " + channelName + " :Cannot join channel (+i)\r\n");
             }
             else if (targetChannel->hasKey() && !targetChannel->checkKey(channelKey))
             {
-                enqueue(client.outbuf, ":server 475 " + client.getNick() + " " + channelName + " :Cannot join channel (+k)\r\n");
+                enqueue(client, ":server 475 " + client.getNick() + " " + channelName + " :Cannot join channel (+k)\r\n");
             }
             else if (targetChannel->getUserLimit() > 0 && (int)targetChannel->getMemberCount() >= targetChannel->getUserLimit())
             {
-                enqueue(client.outbuf, ":server 471 " + client.getNick() + " " + channelName + " :Cannot join channel (+l)\r\n");
+                enqueue(client, ":server 471 " + client.getNick() + " " + channelName + " :Cannot join channel (+l)\r\n");
             }
             continue;
         }
         
-        std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-        std::string joinMsg = ":" + userMask + " JOIN " + channelName + "\r\n";
+        std::string joinMsg = client.getPrefix() + " JOIN " + channelName + "\r\n";
         
         // Kanaldaki herkese JOIN mesajı gönder
         targetChannel->sendMsg(joinMsg, NULL);
-        enqueue(client.outbuf, joinMsg);
+        enqueue(client, joinMsg);
         
         if (!targetChannel->getTopic().empty())
         {
-            enqueue(client.outbuf, ":server 332 " + client.getNick() + " " + channelName + " :" + targetChannel->getTopic() + "\r\n");
+            enqueue(client, ":server 332 " + client.getNick() + " " + channelName + " :" + targetChannel->getTopic() + "\r\n");
         }
         else
         {
-            enqueue(client.outbuf, ":server 331 " + client.getNick() + " " + channelName + " :No topic is set\r\n");
+            enqueue(client, ":server 331 " + client.getNick() + " " + channelName + " :No topic is set\r\n");
         }
         
-        std::string namesList = "";
-        std::vector<Client*> members = targetChannel->getMembers();
-        for (std::vector<Client*>::iterator memberIt = members.begin(); memberIt != members.end(); ++memberIt)
-        {
-            if (!namesList.empty())
-                namesList += " ";
-            
-            // operatörün başına @ eklenmeli
-            if (targetChannel->isOperator(*memberIt))
-                namesList += "@";
-            
-            namesList += (*memberIt)->getNick();
-        }
-        enqueue(client.outbuf, ":server 353 " + client.getNick() + " = " + channelName + " :" + namesList + "\r\n");
+        // operatörlerin başında @, voice'lu üyelerin başında +
+        enqueue(client, ":server 353 " + client.getNick() + " = " + channelName + " :" + targetChannel->namesList() + "\r\n");
         
-        enqueue(client.outbuf, ":server 366 " + client.getNick() + " " + channelName + " :End of /NAMES list\r\n");
+        enqueue(client, ":server 366 " + client.getNick() + " " + channelName + " :End of /NAMES list\r\n");
     }
 }
\ No newline at end of file
@@ -46,9 +46,11 @@ bool validate(const std::string &portS)
 
 int main(int argc, char* argv[])
 {
-    if (argc != 3)
+    if (argc < 3)
     {
-        std::cerr << "Usage: ./irc <port> <password>" << std::endl;
+        std::cerr << "Usage: ./irc <port> <password> [--backend epoll|poll|uring] [--workers N] [--sendq class=bytes[:messages]]"
+            " [--ping SEC] [--ping-timeout SEC] [--reg-timeout SEC] [--idle-timeout SEC]"
+            " [--log LEVEL|subsystem=LEVEL,...] [--oper name:password] [--slow-ms MS] [--metrics SOCKET_PATH]" << std::endl;
         return 1;
     }
     std::string password = argv[2];
@@ -68,8 +70,57 @@ int main(int argc, char* argv[])
         Server server;
         g_server = &server;  // Set global pointer for signal handler
 
+        for (int i = 3; i < argc; ++i)
+        {
+            std::string opt = argv[i];
+            if (opt == "--backend" && i + 1 < argc)
+                server.setBackend(argv[++i]);
+            else if (opt == "--workers" && i + 1 < argc)
+            {
+                int count = std::atoi(argv[++i]);
+                if (count < 0 || count > 256)
+                    throw std::runtime_error("--workers must be between 0 and 256");
+                server.setWorkers(count);
+            }
+            else if (opt == "--sendq" && i + 1 < argc)
+                server.setSendQ(argv[++i]);
+            else if ((opt == "--ping" || opt == "--ping-timeout" || opt == "--reg-timeout") && i + 1 < argc)
+            {
+                int seconds = std::atoi(argv[++i]);
+                if (seconds <= 0)
+                    throw std::runtime_error(opt + " must be a positive number of seconds");
+                server.setTimeouts(opt == "--ping" ? seconds : 0, opt == "--ping-timeout" ? seconds : 0,
+                    opt == "--reg-timeout" ? seconds : 0);
+            }
+            else if (opt == "--idle-timeout" && i + 1 < argc)
+            {
+                int seconds = std::atoi(argv[++i]);
+                if (seconds < 0)
+                    throw std::runtime_error("--idle-timeout must be 0 (off) or a number of seconds");
+                server.setIdleTimeout(seconds);
+            }
+            else if (opt == "--log" && i + 1 < argc)
+                Log::configure(argv[++i]);
+            else if (opt == "--oper" && i + 1 < argc)
+                server.addOper(argv[++i]);
+            else if (opt == "--slow-ms" && i + 1 < argc)
+            {
+                int ms = std::atoi(argv[++i]);
+                if (ms < 0)
+                    throw std::runtime_error("--slow-ms must be 0 (off) or a number of milliseconds");
+                server.setSlowThreshold(ms);
+            }
+            else if (opt == "--metrics" && i + 1 < argc)
+                server.setMetricsSocket(argv[++i]);
+            else
+                throw std::runtime_error("Unknown option: " + opt);
+        }
+
+        Log::start();
         server.start(std::atoi(argv[1]), argv[2]);
+        Log::stop();
     } catch (const std::exception& e) {
+        Log::stop(); // kuyruktakiler hata mesajından önce yazılsın
         std::cerr << "Error: " << e.what() << std::endl;
         g_server = NULL;
         return 1;
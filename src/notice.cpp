@@ -1,45 +1,36 @@
 #include "../include/Server.hpp"
 
+// NOTICE hata cevabı üretmez; satır PRIVMSG gibi doğrudan kuyruğa yazılır
 void Server::handleNotice(const std::vector<std::string>& params, Client &client)
 {
+    client.setLastActivity(this->clock.monotonicMs());
     if (params.size() < 2)
         return ;
     
-    std::string target = params[0];
-    std::string message = params[1];
+    const std::string &target = params[0];
+    const std::string &message = params[1];
     
     if (target[0] == '#' || target[0] == '&')
     {
-        std::map<std::string, Channel*>::iterator channelIt = this->channels.find(target);
-        
-        if (channelIt == this->channels.end())
-            return ;
-        
-        Channel* targetChannel = channelIt->second;
-        if (!targetChannel->hasClient(&client))
+        Channel* targetChannel = findChannel(target);
+        if (!targetChannel || !targetChannel->hasClient(&client))
             return ;
         
-        std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-        std::string noticeMsg = ":" + userMask + " NOTICE " + target + " :" + message + "\r\n";
-        targetChannel->sendMsg(noticeMsg, &client);
+        Reply line;
+        line << client.getPrefix() << " NOTICE " << targetChannel->getName() << " :" << message;
+        SharedMessage *shared = line.take();
+        targetChannel->sendMsg(shared, &client);
+        shared->release();
     }
     else
     {
-        Client* targetClient = NULL;
-        for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
-        {
-            if ((*it)->getNick() == target)
-            {
-                targetClient = *it;
-                break ;
-            }
-        }
+        Client* targetClient = findNick(target);
         
         if (targetClient == NULL)
             return ;
 
-        std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-        std::string noticeMsg = ":" + userMask + " NOTICE " + target + " :" + message + "\r\n";
-        enqueue(targetClient->outbuf, noticeMsg);
+        Reply line(*targetClient);
+        line << client.getPrefix() << " NOTICE " << target << " :" << message;
+        line.send();
     }
 }
@@ -1,99 +1,104 @@
 #include "../include/Server.hpp"
 
 
+// Sıcak yol: hedef ve metin scratch string'lere, satır doğrudan alıcının kuyruğuna yazılır.
+// Kararlı durumda heap allocation yapılmaz (ownTests/alloc_test.cpp).
 void Server::handlePrivMsg(const std::vector<std::string>& params, Client &client)
 {
+    // WHOIS idle süresi ve idle timeout yalnızca mesajlaşmayla sıfırlanır, PING/PONG ile değil
+    client.setLastActivity(this->clock.monotonicMs());
     if (params.size() < 1)
     {
-        enqueue(client.outbuf, ":server 411 " + client.getNick() + " :No recipient given (PRIVMSG)\r\n");
+        Reply err(client);
+        err.numeric("411", client) << " :No recipient given (PRIVMSG)";
+        err.send();
         return;
     }
     
-    std::string target = params[0];    
-    std::string message;
-
     //ikiden fazla parametre varsa cümle olarak mesaj gelmiştir. mesajı birleştir.
-    if (params.size() >= 2)
+    const std::string *message = &this->textScratch;
+    if (params.size() == 2)
+        message = &params[1];
+    else
     {
+        this->textScratch.clear();
         for (size_t i = 1; i < params.size(); ++i)
         {
-            if (i > 1) message += " ";
-            message += params[i];
+            if (i > 1) this->textScratch += ' ';
+            this->textScratch += params[i];
         }
     }
     
-    if (message.empty())
+    if (message->empty())
     {
-        enqueue(client.outbuf, ":server 412 " + client.getNick() + " :No text to send\r\n");
+        Reply err(client);
+        err.numeric("412", client) << " :No text to send";
+        err.send();
         return;
     }
     
-    std::vector<std::string> targetList;
-    std::stringstream targetStream(target);
-
-    while (std::getline(targetStream, target, ','))
-    {
-        if (!target.empty())
-            targetList.push_back(target);
-    }
-
     //targetlar virgülle ayrılmışsa
-    
-    std::string uMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-    
-    for (std::vector<std::string>::iterator targetIt = targetList.begin(); 
-         targetIt != targetList.end(); ++targetIt)
+    const std::string &targets = params[0];
+    for (size_t start = 0; start < targets.size(); )
     {
-        std::string currentTarget = *targetIt;
-        std::string privmsgLine = ":" + uMask + " PRIVMSG " + currentTarget + " :" + message + "\r\n";
+        size_t comma = targets.find(',', start);
+        if (comma == std::string::npos)
+            comma = targets.size();
+        if (comma == start)
+        {
+            ++start;
+            continue;
+        }
+        const std::string *currentTarget = &targets;
+        if (start > 0 || comma < targets.size())
+        {
+            this->targetScratch.assign(targets, start, comma - start);
+            currentTarget = &this->targetScratch;
+        }
+        start = comma + 1;
         
-        if (currentTarget[0] == '#' || currentTarget[0] == '&')
+        if ((*currentTarget)[0] == '#' || (*currentTarget)[0] == '&')
         {
-            std::map<std::string, Channel*>::iterator channelIt = this->channels.find(currentTarget);
+            Channel *channel = findChannel(*currentTarget);
             
-            if (channelIt == this->channels.end())
+            if (!channel || !channel->hasClient(&client))
             {
-                enqueue(client.outbuf, ":server 404 " + client.getNick() + " " + currentTarget + " :Cannot send to channel\r\n");
-                continue;
-            }
-            
-            Channel* targetChannel = channelIt->second;
-           
-            if (!targetChannel->hasClient(&client))
-            {
-                enqueue(client.outbuf, ":server 404 " + client.getNick() + " " + currentTarget + " :Cannot send to channel\r\n");
+                Reply err(client);
+                err.numeric("404", client) << ' ' << *currentTarget << " :Cannot send to channel";
+                err.send();
                 continue;
             }
 
-            targetChannel->sendMsg(privmsgLine, &client);
+            // satır bir kez, paylaşılan bloğa yazılır
+            Reply line;
+            line << client.getPrefix() << " PRIVMSG " << channel->getName() << " :" << *message;
+            SharedMessage *shared = line.take();
+            channel->sendMsg(shared, &client);
+            shared->release();
         }
-
-        
         else
         {
             // Özel mesaj
-            Client* targetClient = NULL;
-            
-            for (std::vector<Client*>::iterator it = clients.begin(); it != clients.end(); ++it)
-            {
-                if ((*it)->getNick() == currentTarget)
-                {
-                    targetClient = *it;
-                    break;
-                }
-            }
+            Client* targetClient = findNick(*currentTarget);
             
             if (targetClient == NULL)
             {
-                enqueue(client.outbuf, ":server 401 " + client.getNick() + " " + currentTarget + " :No such nick/channel\r\n");
+                Reply err(client);
+                err.numeric("401", client) << ' ' << *currentTarget << " :No such nick/channel";
+                err.send();
                 continue;
             }
 
             if (targetClient->isAway())
-                enqueue(client.outbuf, ":server 301 " + client.getNick() + " " + currentTarget + " :" + targetClient->getAwayMessage() + "\r\n");
+            {
+                Reply away(client);
+                away.numeric("301", client) << ' ' << *currentTarget << " :" << targetClient->getAwayMessage();
+                away.send();
+            }
 
-            enqueue(targetClient->outbuf, privmsgLine);
+            Reply line(*targetClient);
+            line << client.getPrefix() << " PRIVMSG " << *currentTarget << " :" << *message;
+            line.send();
         }
     }
 }
-
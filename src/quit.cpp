@@ -6,31 +6,15 @@ void Server::handleQuit(const std::vector<std::string>& params, Client &client)
     if (!params.empty())
         quitMessage = params[0];
 
-    std::string userMask = client.getNick() + "!" + client.getUname() + "@" + client.getHname();
-    std::string quitMsg = ":" + userMask + " QUIT :" + quitMessage + "\r\n";
+    std::string quitMsg = client.getPrefix() + " QUIT :" + quitMessage + "\r\n";
     
-    // Silinecek kanalları topla
-    std::vector<std::string> channelsToDelete;
-    
-    for (std::map<std::string, Channel*>::iterator channelIt = this->channels.begin(); channelIt != this->channels.end(); ++channelIt)
-    {
-        Channel* channel = channelIt->second;
-        
-        if (channel->hasClient(&client))
-        {
-            channel->sendMsg(quitMsg, &client);
-            channel->removeClient(&client);
-            if (channel->getMemberCount() == 0)
-            {
-                delete channel;
-                channelsToDelete.push_back(channelIt->first);
-            }
-        }
-    }
-    for (std::vector<std::string>::iterator it = channelsToDelete.begin(); it != channelsToDelete.end(); ++it)
+    // yalnızca client'ın kanalları; leaveChannel seti küçültür
+    while (!client.getChannels().empty())
     {
-        this->channels.erase(*it);
+        Channel* channel = *client.getChannels().begin();
+        channel->sendMsg(quitMsg, &client);
+        leaveChannel(channel, client);
     }
     
-    enqueue(client.outbuf, "ERROR :Closing Link: " + client.getHname() + " (" + quitMessage + ")\r\n");
+    enqueue(client, "ERROR :Closing Link: " + client.getHname() + " (" + quitMessage + ")\r\n");
 }
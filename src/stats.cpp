@@ -0,0 +1,177 @@
+#include "../include/Server.hpp"
+
+void Server::handleOper(const std::vector<std::string>& params, Client &client)
+{
+    if (this->operators.empty())
+    {
+        Reply err(client);
+        err.numeric("491", client) << " :No O-lines for your host";
+        err.send();
+        return;
+    }
+    // bilinmeyen ad ile yanlış parola aynı cevabı alır
+    std::map<std::string, std::string>::const_iterator it = this->operators.find(params[0]);
+    if (it == this->operators.end() || it->second != params[1])
+    {
+        Reply err(client);
+        err.numeric("464", client) << " :Password incorrect";
+        err.send();
+        return;
+    }
+    client.setOper(true);
+    Reply ok(client);
+    ok.numeric("381", client) << " :You are now an IRC operator";
+    ok.send();
+    Reply mode(client);
+    mode << ':' << client.getNick() << " MODE " << client.getNick() << " :+o";
+    mode.send();
+}
+
+// 850ns, 12.4us, 3.1ms, 1.20s
+static std::string duration(double ns)
+{
+    char text[32];
+    if (ns < 1000)
+        std::snprintf(text, sizeof(text), "%.0fns", ns);
+    else if (ns < 1000000)
+        std::snprintf(text, sizeof(text), "%.1fus", ns / 1000);
+    else if (ns < 1000000000)
+        std::snprintf(text, sizeof(text), "%.1fms", ns / 1000000);
+    else
+        std::snprintf(text, sizeof(text), "%.2fs", ns / 1000000000);
+    return text;
+}
+
+static std::string number(unsigned long long n)
+{
+    char text[24];
+    std::snprintf(text, sizeof(text), "%llu", n);
+    return text;
+}
+
+static void statsLine(Client &client, const std::string &text)
+{
+    Reply line(client);
+    line.numeric("249", client) << ' ' << text;
+    line.send();
+}
+
+// ms eşikleri cycles'a çevrilir; döngü başlamadan bir kez, TSC hızı ölçülerek
+void Server::calibrateLag()
+{
+    double ns = this->clock.cycleNs();
+    double limit = 1000000 / ns; // 1 ms
+    for (int i = 0; i < LAG_LEVELS; ++i, limit *= 10)
+        this->loop.limits[i] = (unsigned long long)limit;
+    if (this->slowMs > 0)
+        this->loop.slowLimit = (unsigned long long)(this->slowMs * 1000000.0 / ns);
+}
+
+// her turda: iki sayaç ve bir histogram kaydı; log yalnızca eşik aşılınca
+void Server::endTurn(unsigned long long busy, unsigned long long waited, size_t events)
+{
+    this->loop.busy.record(busy);
+    this->loop.worked += busy;
+    this->loop.waited += waited;
+    for (int i = 0; i < LAG_LEVELS && busy >= this->loop.limits[i]; ++i)
+        ++this->loop.over[i];
+    if (busy < this->loop.slowLimit)
+        return;
+    ++this->loop.slowTurns;
+    double ns = this->clock.cycleNs();
+    LOG(CORE, WARN) << "Slow event loop turn: " << duration(busy * ns) << " busy after "
+        << duration(waited * ns) << " waiting, " << (unsigned long)events << " events";
+}
+
+// komut handler'dan sonra loglanır; client bu arada gitmiş olabilir (QUIT, SendQ)
+void Server::slowCommand(const CommandEntry &entry, const std::vector<std::string> &params, int fd, unsigned long long elapsed)
+{
+    ++this->loop.slowCommands;
+    Client *client = findClient(fd);
+    LOG(CMD, WARN) << "Slow command: " << entry.name << (params.empty() ? "" : " ") << (params.empty() ? "" : params[0])
+        << " from " << (client && !client->getNick().empty() ? client->getNick() : "*") << " (fd " << fd << ") took "
+        << duration(elapsed * this->clock.cycleNs());
+}
+
+// STATS m: RFC 1459 212 satırı (komut, çağrı, gelen byte), ardından 249 ile gecikme dağılımı.
+// STATS e: döngü turlarında bekleme/iş ayrımı ve gecikme sayaçları. STATS u: çalışma süresi. STATS z: havuzlar, buffer'lar, timer'lar ve log kuyruğu.
+void Server::handleStats(const std::vector<std::string>& params, Client &client)
+{
+    if (!client.isOper())
+    {
+        Reply err(client);
+        err.numeric("481", client) << " :Permission Denied- You're not an IRC operator";
+        err.send();
+        return;
+    }
+    char query = params[0][0];
+    if (query == 'm' || query == 'M')
+    {
+        double ns = this->clock.cycleNs();
+        for (size_t i = 0; i < this->commandStats.size(); ++i)
+        {
+            const CommandStats &stats = this->commandStats[i];
+            const Histogram &latency = stats.latency;
+            if (latency.count() == 0)
+                continue;
+            const char *name = commandAt(i).name;
+            Reply usage(client);
+            usage.numeric("212", client) << ' ' << name << ' ' << number(latency.count()) << ' ' << number(stats.bytesIn) << " 0";
+            usage.send();
+            statsLine(client, std::string("m :") + name + " calls " + number(latency.count())
+                + " in " + number(stats.bytesIn) + " out " + number(stats.bytesOut)
+                + " p50 " + duration(latency.percentile(0.5) * ns)
+                + " p99 " + duration(latency.percentile(0.99) * ns)
+                + " p999 " + duration(latency.percentile(0.999) * ns)
+                + " max " + duration(latency.max() * ns));
+        }
+    }
+    else if (query == 'e' || query == 'E')
+    {
+        const LoopStats &loop = this->loop;
+        double ns = this->clock.cycleNs();
+        unsigned long long total = loop.worked + loop.waited;
+        statsLine(client, "e :turns " + number(loop.busy.count()) + " busy " + duration(loop.worked * ns)
+            + " (" + number(total ? loop.worked * 100 / total : 0) + "%) waiting " + duration(loop.waited * ns));
+        statsLine(client, "e :busy per turn p50 " + duration(loop.busy.percentile(0.5) * ns)
+            + " p99 " + duration(loop.busy.percentile(0.99) * ns)
+            + " p999 " + duration(loop.busy.percentile(0.999) * ns)
+            + " max " + duration(loop.busy.max() * ns));
+        statsLine(client, "e :over 1ms " + number(loop.over[0]) + " over 10ms " + number(loop.over[1])
+            + " over 100ms " + number(loop.over[2]));
+        std::string limit = this->slowMs > 0 ? number(this->slowMs) + "ms" : std::string("off");
+        statsLine(client, "e :slow (" + limit + ") turns " + number(loop.slowTurns)
+            + " commands " + number(loop.slowCommands));
+    }
+    else if (query == 'u' || query == 'U')
+    {
+        time_t up = this->clock.wallSeconds() - this->created;
+        char text[64];
+        std::snprintf(text, sizeof(text), " :Server Up %ld days %ld:%02ld:%02ld",
+            (long)(up / 86400), (long)(up / 3600 % 24), (long)(up / 60 % 60), (long)(up % 60));
+        Reply line(client);
+        line.numeric("242", client) << text;
+        line.send();
+    }
+    else if (query == 'z' || query == 'Z')
+    {
+        const PoolStats &cl = getClientPoolStats();
+        const PoolStats &ch = getChannelPoolStats();
+        const BufferPoolStats &buf = BufferPool::stats();
+        LogStats log = Log::stats();
+        statsLine(client, "z :clients " + number(cl.inUse) + " peak " + number(cl.peak)
+            + " slots " + number(cl.capacity) + " slabs " + number(cl.slabs));
+        statsLine(client, "z :channels " + number(ch.inUse) + " peak " + number(ch.peak)
+            + " slots " + number(ch.capacity) + " slabs " + number(ch.slabs));
+        statsLine(client, "z :buffers borrowed " + number(buf.borrowed) + " (" + number(buf.borrowedBytes)
+            + " bytes) cached " + number(buf.cached) + " (" + number(buf.cachedBytes)
+            + " bytes) peak " + number(buf.peakBytes) + " bytes hits " + number(buf.hits)
+            + " misses " + number(buf.misses) + " trimmed " + number(buf.trimmed));
+        statsLine(client, "z :buffered " + number(bufferedBytes()) + " bytes timers " + number(this->timers.size()));
+        statsLine(client, "z :log logged " + number(log.logged) + " dropped " + number(log.dropped)
+            + " truncated " + number(log.truncated));
+    }
+    Reply end(client);
+    end.numeric("219", client) << ' ' << query << " :End of STATS report";
+    end.send();
+}